@@ -149,9 +149,19 @@ public:
   unsigned num_channels() const override;
 
 private:
+  internal::BSGS::order_type num_automorphisms_(
+    AutomorphismOptions const *,
+    internal::timeout::flag ) const override
+  {
+    if (num_processors() == 0u)
+      return 1;
+
+    return num_automorphisms_nauty();
+  }
+
   internal::PermGroup automorphisms_(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted) override
+    internal::timeout::flag aborted) const override
   {
     if (num_processors() == 0u)
       return internal::PermGroup();
@@ -159,10 +169,6 @@ private:
     return automorphisms_nauty(options, aborted);
   }
 
-  void init_repr_(AutomorphismOptions const *options,
-                  internal::timeout::flag aborted) override
-  { automorphisms(options, aborted); }
-
   // Convenience functions
 
   ChannelType assert_channel_type(std::string const &cl);
@@ -218,11 +224,13 @@ private:
 
   std::string to_gap_nauty() const;
 
-  internal::PermSet automorphism_generators_nauty();
+  internal::PermSet automorphism_generators_nauty() const;
+
+  internal::BSGS::order_type num_automorphisms_nauty() const;
 
   internal::PermGroup automorphisms_nauty(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted);
+    internal::timeout::flag aborted) const;
 
   adjacency_type _adj;
   bool _directed;
@@ -64,7 +64,7 @@ public:
 
 private:
   PermGroup automorphisms_(AutomorphismOptions const *,
-                           internal::timeout::flag) override
+                           internal::timeout::flag) const override
   { return _automorphisms; }
 
   PermGroup _automorphisms;
@@ -27,11 +27,7 @@ public:
   std::string to_json() const override;
 
   // TODO: detect equivalent subsystems?
-  void add_subsystem(std::shared_ptr<ArchGraphSystem> subsystem)
-  {
-    reset_automorphisms();
-    _subsystems.push_back(subsystem);
-  }
+  void add_subsystem(std::shared_ptr<ArchGraphSystem> subsystem);
 
   std::vector<std::shared_ptr<ArchGraphSystem>> subsystems() const
   { return _subsystems; }
@@ -43,7 +39,7 @@ public:
 private:
   internal::BSGS::order_type num_automorphisms_(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted) override
+    internal::timeout::flag aborted) const override
   {
     internal::BSGS::order_type ret = 1;
     for (auto const &subsystem : _subsystems)
@@ -53,10 +49,10 @@ private:
   }
 
   internal::PermGroup automorphisms_(AutomorphismOptions const *options,
-                                     internal::timeout::flag aborted) override;
+                                     internal::timeout::flag aborted) const override;
 
   void init_repr_(AutomorphismOptions const *options,
-                  internal::timeout::flag aborted) override
+                  internal::timeout::flag aborted) const override
   {
     for (auto const &subsystem : _subsystems) {
       if (!subsystem->repr_ready())
@@ -83,7 +79,7 @@ private:
   TaskMapping repr_(TaskMapping const &mapping,
                     ReprOptions const *options,
                     TMORs *orbits,
-                    internal::timeout::flag aborted) override;
+                    internal::timeout::flag aborted) const override;
 
   std::vector<std::shared_ptr<ArchGraphSystem>> _subsystems;
 };
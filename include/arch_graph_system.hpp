@@ -1,13 +1,17 @@
 #ifndef GUARD_ARCH_GRAPH_SYSTEM_H
 #define GUARD_ARCH_GRAPH_SYSTEM_H
 
+#include <cassert>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <unordered_set>
+#include <vector>
 
 #include "bsgs.hpp"
+#include "once.hpp"
 #include "perm_group.hpp"
+#include "random.hpp"
 #include "string.hpp"
 #include "task_mapping.hpp"
 #include "task_mapping_orbit.hpp"
@@ -24,6 +28,7 @@ struct ReprOptions
     ITERATE,
     LOCAL_SEARCH,
     ORBITS,
+    CANONICAL,
     AUTO = ITERATE
   };
 
@@ -33,6 +38,13 @@ struct ReprOptions
     LOCAL_SEARCH_SA_LINEAR
   };
 
+  enum class Decomposition {
+    NONE,
+    DISJOINT,
+    WREATH,
+    AUTO
+  };
+
   static ReprOptions fill_defaults(ReprOptions const *options)
   {
     static ReprOptions default_options;
@@ -42,6 +54,11 @@ struct ReprOptions
   Method method = Method::AUTO;
   Variant variant = Variant::LOCAL_SEARCH_BFS;
 
+  // if not NONE, flat automorphism groups are decomposed into disjoint or
+  // wreath product factors (AUTO tries both, in that order) and
+  // representatives are determined factor by factor
+  Decomposition decomposition = Decomposition::NONE;
+
   unsigned offset = 0u;
 
   bool match = true;
@@ -50,6 +67,10 @@ struct ReprOptions
   unsigned local_search_append_generators = 0u;
   unsigned local_search_sa_iterations = 100u;
   double local_search_sa_T_init = 1.0;
+
+  // engine used by the randomized local search variants, defaults to a
+  // randomly seeded engine private to the calling thread
+  util::random_engine_type *random_engine = nullptr;
 };
 
 class ArchGraphSystem
@@ -84,41 +105,56 @@ public:
   virtual unsigned num_channels() const
   { throw std::logic_error("not implemented"); }
 
+  // all lazily initialized state (automorphisms, their order, representative
+  // related data) is initialized exactly once even if requested by several
+  // threads at the same time, afterwards it is only read, so automorphisms and
+  // representatives can be determined concurrently without external locking,
+  // resetting or extending the automorphisms however must not happen
+  // concurrently with any other operation
   bool automorphisms_ready() const
-  { return _automorphisms_valid; }
+  { return _automorphisms_once.done(); }
 
   void reset_automorphisms()
   {
-    _automorphisms_valid = false;
-    _automorphisms_is_symmetric_valid = false;
+    _automorphisms_once.reset();
+    _automorphisms_is_symmetric_once.reset();
+    _num_automorphisms_once.reset();
+    _repr_factors_disjoint_once.reset();
+    _repr_factors_wreath_once.reset();
   }
 
   virtual unsigned automorphisms_degree() const
   { return num_processors(); }
 
+  // the group order is cached separately from the automorphism group itself,
+  // implementations may be able to determine it without constructing a BSGS
   internal::BSGS::order_type num_automorphisms(
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset())
-  { return num_automorphisms_(options, aborted); }
+    internal::timeout::flag aborted = internal::timeout::unset()) const
+  {
+    _num_automorphisms_once.call_once([&]{
+      _num_automorphisms = automorphisms_ready()
+                         ? _automorphisms.order()
+                         : num_automorphisms_(options, aborted);
+    });
+
+    return _num_automorphisms;
+  }
 
   internal::PermGroup automorphisms(
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset())
+    internal::timeout::flag aborted = internal::timeout::unset()) const
   {
-    if (!automorphisms_ready()) {
-      _automorphisms = automorphisms_(options, aborted);
-      _automorphism_generators = _automorphisms.generators().with_inverses();
-      _automorphisms_valid = true;
-    }
+    init_automorphisms(options, aborted);
 
     return _automorphisms;
   }
 
   virtual internal::PermSet automorphisms_generators(
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset())
+    internal::timeout::flag aborted = internal::timeout::unset()) const
   {
-    automorphisms(options, aborted);
+    init_automorphisms(options, aborted);
 
     return _automorphism_generators;
   }
@@ -126,11 +162,11 @@ public:
   TMO automorphisms_orbit(
     TaskMapping const &mapping,
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset());
+    internal::timeout::flag aborted = internal::timeout::unset()) const;
 
   void init_repr(
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset())
+    internal::timeout::flag aborted = internal::timeout::unset()) const
   {
     if (!repr_ready_())
       init_repr_(options, aborted);
@@ -145,7 +181,7 @@ public:
   TaskMapping repr(
     TaskMapping const &mapping,
     ReprOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset())
+    internal::timeout::flag aborted = internal::timeout::unset()) const
   {
     if (!repr_ready_())
       init_repr();
@@ -157,7 +193,7 @@ public:
     TaskMapping const &mapping,
     TMORs &orbits,
     ReprOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset())
+    internal::timeout::flag aborted = internal::timeout::unset()) const
   {
     if (!repr_ready_())
       init_repr();
@@ -169,21 +205,82 @@ public:
     return std::make_tuple(representative, ins.first, ins.second);
   }
 
+  // representatives are inserted into orbits but, unlike above, not matched
+  // against the representatives already contained in it while being determined
+  std::tuple<TaskMapping, bool, unsigned> repr(
+    TaskMapping const &mapping,
+    ConcurrentTMORs &orbits,
+    ReprOptions const *options = nullptr,
+    internal::timeout::flag aborted = internal::timeout::unset()) const
+  {
+    auto representative(repr(mapping, options, aborted));
+
+    auto ins(orbits.insert(representative));
+
+    return std::make_tuple(representative, ins.first, ins.second);
+  }
+
+  // equivalent to calling repr for all mappings in order, but representatives
+  // are determined concurrently by up to num_threads threads and only merged
+  // into orbits afterwards (in the order of mappings), explicitly specified
+  // random engines can't be shared between threads, in that case
+  // representatives are always determined sequentially
+  std::vector<std::tuple<TaskMapping, bool, unsigned>> repr_batch(
+    std::vector<TaskMapping> const &mappings,
+    TMORs &orbits,
+    ReprOptions const *options = nullptr,
+    unsigned num_threads = 1u,
+    internal::timeout::flag aborted = internal::timeout::unset()) const;
+
+protected:
+  void extend_automorphisms(
+    internal::PermSet const &generators,
+    AutomorphismOptions const *options = nullptr,
+    internal::timeout::flag aborted = internal::timeout::unset())
+  {
+    assert(automorphisms_ready());
+
+    _automorphisms = _automorphisms.closure(generators, options, aborted);
+    _automorphism_generators = _automorphisms.generators().with_inverses();
+    _automorphisms_is_symmetric_once.reset();
+    _num_automorphisms_once.reset();
+    _repr_factors_disjoint_once.reset();
+    _repr_factors_wreath_once.reset();
+  }
+
 private:
   virtual internal::BSGS::order_type num_automorphisms_(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted)
+    internal::timeout::flag aborted) const
   { return automorphisms(options, aborted).order(); }
 
   virtual internal::PermGroup automorphisms_(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted) = 0;
+    internal::timeout::flag aborted) const = 0;
 
-  bool automorphisms_symmetric(ReprOptions const *options);
+  void init_automorphisms(AutomorphismOptions const *options,
+                          internal::timeout::flag aborted) const
+  {
+    _automorphisms_once.call_once([&]{
+      _automorphisms = automorphisms_(options, aborted);
+      _automorphism_generators = _automorphisms.generators().with_inverses();
+    });
+  }
+
+  bool automorphisms_symmetric(ReprOptions const *options) const;
+
+  bool automorphisms_decomposable(
+    ReprOptions const *options,
+    std::vector<std::shared_ptr<ArchGraphSystem>> const **factors) const;
 
-  virtual void init_repr_(AutomorphismOptions const *,
-                          internal::timeout::flag )
-  {}
+  std::vector<std::shared_ptr<ArchGraphSystem>> const &
+  automorphisms_decomposition(ReprOptions::Decomposition decomposition) const;
+
+  std::vector<bool> automorphisms_moved() const;
+
+  virtual void init_repr_(AutomorphismOptions const *options,
+                          internal::timeout::flag aborted) const
+  { init_automorphisms(options, aborted); }
 
   virtual bool repr_ready_() const
   { return automorphisms_ready(); }
@@ -194,7 +291,7 @@ private:
   virtual TaskMapping repr_(TaskMapping const &mapping,
                             ReprOptions const *options,
                             TMORs *orbits,
-                            internal::timeout::flag aborted);
+                            internal::timeout::flag aborted) const;
 
   static bool is_repr(TaskMapping const &tasks,
                       ReprOptions const *options,
@@ -216,6 +313,10 @@ private:
                               TMORs *orbits,
                               internal::timeout::flag aborted) const;
 
+  TaskMapping min_elem_canonical(TaskMapping const &tasks,
+                                 ReprOptions const *options,
+                                 internal::timeout::flag aborted) const;
+
   TaskMapping min_elem_local_search(TaskMapping const &tasks,
                                     ReprOptions const *options) const;
 
@@ -234,16 +335,29 @@ private:
   TaskMapping min_elem_symmetric(TaskMapping const &tasks,
                                  ReprOptions const *options) const;
 
-  internal::PermGroup _automorphisms;
-  internal::PermSet _automorphism_generators;
+  TaskMapping min_elem_decomposed(
+    TaskMapping const &tasks,
+    ReprOptions const *options,
+    std::vector<std::shared_ptr<ArchGraphSystem>> const &factors,
+    internal::timeout::flag aborted) const;
+
+  mutable internal::PermGroup _automorphisms;
+  mutable internal::PermSet _automorphism_generators;
+  mutable util::OnceFlag _automorphisms_once;
+
+  mutable bool _automorphisms_is_symmetric;
+  mutable unsigned _automorphisms_smp;
+  mutable unsigned _automorphisms_lmp;
+  mutable util::OnceFlag _automorphisms_is_symmetric_once;
 
-  bool _automorphisms_valid = false;
+  mutable internal::BSGS::order_type _num_automorphisms;
+  mutable util::OnceFlag _num_automorphisms_once;
 
-  bool _automorphisms_is_symmetric;
-  bool _automorphisms_is_symmetric_valid = false;
+  mutable std::vector<std::shared_ptr<ArchGraphSystem>> _repr_factors_disjoint;
+  mutable util::OnceFlag _repr_factors_disjoint_once;
 
-  unsigned _automorphisms_smp;
-  unsigned _automorphisms_lmp;
+  mutable std::vector<std::shared_ptr<ArchGraphSystem>> _repr_factors_wreath;
+  mutable util::OnceFlag _repr_factors_wreath_once;
 };
 
 } // namespace mpsym
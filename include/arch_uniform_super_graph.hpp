@@ -9,6 +9,7 @@
 #include "arch_graph_automorphisms.hpp"
 #include "arch_graph_system.hpp"
 #include "bsgs.hpp"
+#include "once.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
 
@@ -40,7 +41,7 @@ public:
 
   internal::PermSet automorphisms_generators(
     AutomorphismOptions const *options = nullptr,
-    internal::timeout::flag aborted = internal::timeout::unset()) override
+    internal::timeout::flag aborted = internal::timeout::unset()) const override
   {
     return internal::PermGroup::wreath_product_generators(
       _subsystem_proto->automorphisms_generators(options, aborted),
@@ -50,7 +51,7 @@ public:
 private:
   internal::BSGS::order_type num_automorphisms_(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted) override
+    internal::timeout::flag aborted) const override
   {
     return internal::PermGroup::wreath_product_order(
       _subsystem_proto->automorphisms(options, aborted),
@@ -59,10 +60,10 @@ private:
 
   internal::PermGroup automorphisms_(
     AutomorphismOptions const *options,
-    internal::timeout::flag aborted) override;
+    internal::timeout::flag aborted) const override;
 
   void init_repr_(AutomorphismOptions const *options,
-                  internal::timeout::flag aborted) override;
+                  internal::timeout::flag aborted) const override;
 
   bool repr_ready_() const override;
 
@@ -71,7 +72,7 @@ private:
   TaskMapping repr_(TaskMapping const &mapping_,
                     ReprOptions const *options,
                     TMORs *orbits,
-                    internal::timeout::flag aborted) override;
+                    internal::timeout::flag aborted) const override;
 
   std::shared_ptr<internal::ArchGraphAutomorphisms>
   wreath_product_action_super_graph(AutomorphismOptions const *options,
@@ -84,13 +85,13 @@ private:
   std::shared_ptr<ArchGraphSystem> _subsystem_super_graph;
   std::shared_ptr<ArchGraphSystem> _subsystem_proto;
 
-  bool _super_graph_trivial = false;
-  bool _proto_trivial = false;
+  mutable bool _super_graph_trivial = false;
+  mutable bool _proto_trivial = false;
 
-  std::shared_ptr<internal::ArchGraphAutomorphisms> _sigma_total;
-  std::shared_ptr<internal::ArchGraphAutomorphisms> _sigma_super_graph;
-  std::vector<std::shared_ptr<internal::ArchGraphAutomorphisms>> _sigmas_proto;
-  bool _sigmas_valid = false;
+  mutable std::shared_ptr<internal::ArchGraphAutomorphisms> _sigma_total;
+  mutable std::shared_ptr<internal::ArchGraphAutomorphisms> _sigma_super_graph;
+  mutable std::vector<std::shared_ptr<internal::ArchGraphAutomorphisms>> _sigmas_proto;
+  mutable util::OnceFlag _sigmas_once;
 };
 
 } // namespace mpsym
@@ -2,6 +2,7 @@
 #define GUARD_BSGS_H
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
 #include <ostream>
 #include <stdexcept>
@@ -13,6 +14,7 @@
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "perm_set.hpp"
+#include "random.hpp"
 #include "timeout.hpp"
 
 namespace mpsym
@@ -37,14 +39,29 @@ public:
     unsigned i, unsigned root, unsigned degree);
 
   void update_schreier_structure(
-    unsigned i, unsigned root, unsigned degree, PermSet const &generators);
+    unsigned i, unsigned root, unsigned degree, PermSet const &generators,
+    PermSet const &generators_fixing_orbit = PermSet());
+
+  void update_schreier_structure(
+    unsigned i, unsigned root, unsigned degree, PermSet const &generators,
+    std::shared_ptr<PermSet const> const &generators_fixing_orbit,
+    unsigned num_generators_fixing_orbit);
 
   void insert_schreier_structure(
     unsigned i, unsigned root, unsigned degree, PermSet const &generators);
 
+  void restore_schreier_structure(
+    unsigned i, std::shared_ptr<SchreierStructure> const &ss)
+  { _schreier_structures[i] = ss; }
+
+  void truncate(unsigned size)
+  { _schreier_structures.resize(size); }
+
   void clear()
   { _schreier_structures.clear(); }
 
+  virtual std::shared_ptr<BSGSTransversalsBase> clone() const = 0;
+
   virtual std::shared_ptr<SchreierStructure> make_schreier_structure(
     unsigned root, unsigned degree, PermSet const &generators) = 0;
 
@@ -58,6 +75,9 @@ class BSGSTransversals : public BSGSTransversalsBase
 public:
   virtual ~BSGSTransversals() = default;
 
+  std::shared_ptr<BSGSTransversalsBase> clone() const override
+  { return std::make_shared<BSGSTransversals<T>>(*this); }
+
 private:
   std::shared_ptr<SchreierStructure> make_schreier_structure(
     unsigned root, unsigned degree, PermSet const &generators) override
@@ -99,16 +119,40 @@ public:
        PermSet const &strong_generators,
        BSGSOptions const *options = nullptr);
 
+  // explicit constructions for well known groups acting on {0, ..., degree - 1},
+  // dihedral groups of degree less than three are symmetric
+  static BSGS symmetric(unsigned degree, BSGSOptions const *options = nullptr);
+  static BSGS alternating(unsigned degree, BSGSOptions const *options = nullptr);
+  static BSGS cyclic(unsigned degree, BSGSOptions const *options = nullptr);
+  static BSGS dihedral(unsigned degree, BSGSOptions const *options = nullptr);
+
+  // explicit constructions from the BSGSs of factor groups
+  static BSGS direct_product(std::vector<BSGS> const &factors,
+                             BSGSOptions const *options = nullptr);
+
+  static BSGS wreath_product(BSGS const &lhs,
+                             BSGS const &rhs,
+                             BSGSOptions const *options = nullptr);
+
   unsigned degree() const { return _degree; }
   order_type order() const;
 
   bool is_symmetric() const { return _is_symmetric; }
+  bool is_alternating() const { return _is_alternating; }
 
   Base base() const { return _base; }
   bool base_empty() const { return _base.empty(); }
   unsigned base_size() const { return _base.size(); }
   unsigned base_point(unsigned i) const { return _base[i]; }
-  void base_change(std::vector<unsigned> prefix);
+  void base_change(std::vector<unsigned> prefix,
+                   BSGSOptions const *options = nullptr);
+
+  // copy of this BSGS with a base starting with prefix, schreier structures of
+  // levels unaffected by the base change are shared with this BSGS
+  BSGS with_base_prefix(std::vector<unsigned> const &prefix,
+                        BSGSOptions const *options = nullptr) const;
+
+  bool has_base_prefix(std::vector<unsigned> const &prefix) const;
 
   PermSet strong_generators() const { return _strong_generators; }
   PermSet strong_generators(unsigned i) const;
@@ -120,6 +164,12 @@ public:
 
   std::pair<Perm, unsigned> strip(Perm const &perm, unsigned offs = 0) const;
   bool strips_completely(Perm const &perm) const;
+  std::vector<bool> strips_completely(std::vector<Perm> const &perms,
+                                      unsigned num_threads = 1u) const;
+
+  void extend(PermSet const &generators,
+              BSGSOptions const *options = nullptr,
+              timeout::flag aborted = timeout::unset());
 
 private:
   // transversal initialization
@@ -127,6 +177,7 @@ private:
 
   // construction
   void construct_symmetric(std::vector<unsigned> const &support);
+  void construct_alternating(std::vector<unsigned> const &support);
 
   void construct_unknown(PermSet const &generators,
                          BSGSOptions const *options,
@@ -140,7 +191,15 @@ private:
   void schreier_sims(std::vector<PermSet> &strong_generators,
                      std::vector<Orbit> &fundamental_orbits,
                      BSGSOptions const *options,
-                     timeout::flag aborted);
+                     timeout::flag aborted,
+                     int level = -1);
+
+  int schreier_sims_main(std::vector<PermSet> &strong_generators,
+                         std::vector<Orbit> &fundamental_orbits,
+                         BSGSOptions const *options,
+                         timeout::flag aborted,
+                         int level,
+                         unsigned subset);
 
   void schreier_sims_random(PermSet const &generators,
                             BSGSOptions const *options,
@@ -163,26 +222,62 @@ private:
 
   void schreier_sims_finish();
 
+  // batched stripping
+  void strips_completely_range(std::vector<Perm> const &perms,
+                               std::size_t first,
+                               std::size_t last,
+                               std::vector<bool> &res) const;
+
+  // incremental extension
+  void extend_init(unsigned degree,
+                   std::vector<PermSet> &strong_generators,
+                   std::vector<Orbit> &fundamental_orbits);
+
+  int extend_sift(Perm const &generator,
+                  std::vector<PermSet> &strong_generators,
+                  std::vector<Orbit> &fundamental_orbits);
+
   // solvable BSGS initialization
+  struct SolveCheckpoint
+  {
+    unsigned base_size;
+    unsigned num_strong_generators;
+
+    // undo log of the schreier structures of levels that already existed when
+    // the checkpoint was taken and have been replaced since, levels appended
+    // after the checkpoint are simply truncated on rollback
+    std::vector<std::shared_ptr<SchreierStructure>> replaced;
+  };
+
   void solve(PermSet const &generators);
 
   bool solve_s_normal_closure(PermSet const &generators,
                               Perm const &w,
                               std::pair<Perm, Perm> &conjugates);
 
-  void solve_adjoin_normalizing_generator(Perm const &gen);
+  void solve_adjoin_normalizing_generator(Perm const &gen,
+                                          SolveCheckpoint &checkpoint);
+
+  SolveCheckpoint solve_checkpoint() const;
+  void solve_rollback(SolveCheckpoint const &checkpoint);
+
+  bool solve_strips_completely_checkpoint(
+    Perm const &perm, SolveCheckpoint const &checkpoint) const;
 
   // generator reduction
   void reduce_gens();
 
-  std::unordered_set<Perm> reduce_gens_set_difference(
-    std::unordered_set<Perm> const &lhs,
-    std::unordered_set<Perm> const &rhs,
-    std::unordered_set<Perm> const &base) const;
+  static unsigned reduce_gens_find_rep(unsigned k,
+                                       std::vector<unsigned> &classpath);
+
+  static bool reduce_gens_merge_classes(unsigned k1,
+                                        unsigned k2,
+                                        std::vector<unsigned> &classpath,
+                                        std::vector<unsigned> &cardinalities);
 
   // base change
-  void swap_base_points(unsigned i);
-  void transpose_base_point(unsigned i, unsigned j);
+  void swap_base_points(unsigned i, BSGSOptions const *options);
+  void transpose_base_point(unsigned i, unsigned j, BSGSOptions const *options);
   unsigned insert_redundant_base_point(unsigned bp, unsigned i_min);
   void conjugate(Perm const &conj);
 
@@ -199,10 +294,24 @@ private:
       i, base_point(i), _degree);
   }
 
-  void update_schreier_structure(unsigned i, PermSet const &generators)
+  void update_schreier_structure(
+    unsigned i,
+    PermSet const &generators,
+    PermSet const &generators_fixing_orbit = PermSet())
   {
     _transversals->update_schreier_structure(
-      i, base_point(i), _degree, generators);
+      i, base_point(i), _degree, generators, generators_fixing_orbit);
+  }
+
+  void update_schreier_structure(
+    unsigned i,
+    PermSet const &generators,
+    std::shared_ptr<PermSet const> const &generators_fixing_orbit,
+    unsigned num_generators_fixing_orbit)
+  {
+    _transversals->update_schreier_structure(
+      i, base_point(i), _degree, generators,
+      generators_fixing_orbit, num_generators_fixing_orbit);
   }
 
   void insert_schreier_structure(unsigned i, PermSet const &generators)
@@ -250,6 +359,20 @@ struct BSGSOptions
   bool check_sym = true;
   bool reduce_gens = true;
 
+  // base changes complete the swapped stabilizer chain levels from random
+  // elements instead of enumerating all schreier generators
+  bool base_change_randomized = true;
+
+  // remembers all Schreier generators returned so far for every stabilizer
+  // chain level in order to skip duplicates, which can require a lot of memory
+  // for large groups
+  bool schreier_sims_dedupe_schreier_generators = false;
+  unsigned schreier_sims_schreier_generator_subset = 0u;
+
+  // engine used by all randomized algorithms, defaults to a randomly seeded
+  // engine private to the calling thread
+  util::random_engine_type *random_engine = nullptr;
+
   bool schreier_sims_random_guarantee = true;
   bool schreier_sims_random_use_known_order = true;
   BSGS::order_type schreier_sims_random_known_order = 0;
@@ -34,6 +34,7 @@ struct ExplicitTransversals : public SchreierStructure
 
   unsigned root() const override;
   std::vector<unsigned> nodes() const override;
+  unsigned size() const override;
   PermSet labels() const override;
 
   bool contains(unsigned node) const override;
@@ -47,6 +48,7 @@ private:
   unsigned _root;
   PermSet _labels;
   std::map<unsigned, Perm> _orbit;
+  std::map<unsigned, unsigned> _edge_labels;
 };
 
 } // namespace internal
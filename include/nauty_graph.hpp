@@ -34,7 +34,14 @@ public:
 
   PermSet automorphism_generators();
 
+  // lengths of the fundamental orbits of a stabilizer chain of the graph's
+  // automorphism group (restricted to the first n_reduced vertices), their
+  // product is the group's order
+  std::vector<unsigned> automorphism_orbit_lengths();
+
 private:
+  void call_nauty(bool save_generators);
+
   bool _directed;
   int _n, _n_reduced;
   int *_lab, *_ptn, *_orbits;
@@ -0,0 +1,67 @@
+#ifndef GUARD_ONCE_H
+#define GUARD_ONCE_H
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace mpsym
+{
+
+namespace util
+{
+
+// like std::once_flag but resettable and copyable, once initialization has
+// been performed, call_once only costs a single atomic load, if the callable
+// throws, initialization is attempted again by the next call, copies share the
+// original's state but not its mutex, reset must not be called concurrently
+// with call_once
+class OnceFlag
+{
+public:
+  OnceFlag()
+  : _done(false)
+  {}
+
+  OnceFlag(OnceFlag const &other)
+  : _done(other.done())
+  {}
+
+  OnceFlag &operator=(OnceFlag const &other)
+  {
+    _done.store(other.done(), std::memory_order_release);
+    return *this;
+  }
+
+  bool done() const
+  { return _done.load(std::memory_order_acquire); }
+
+  void reset()
+  { _done.store(false, std::memory_order_release); }
+
+  template<typename FUNC>
+  void call_once(FUNC &&f)
+  {
+    if (done())
+      return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (done())
+      return;
+
+    std::forward<FUNC>(f)();
+
+    _done.store(true, std::memory_order_release);
+  }
+
+private:
+  std::atomic<bool> _done;
+  std::mutex _mutex;
+};
+
+} // namespace util
+
+} // namespace mpsym
+
+#endif // GUARD_ONCE_H
@@ -2,7 +2,10 @@
 #define GUARD_PERM_GROUP_H
 
 #include <cassert>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -12,6 +15,7 @@
 #include "bsgs.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
+#include "random.hpp"
 #include "timeout.hpp"
 #include "util.hpp"
 
@@ -39,12 +43,18 @@ public:
   public:
     const_iterator() : _end(true) {};
     const_iterator(PermGroup const &pg);
+    explicit const_iterator(BSGS const &bsgs);
 
     bool operator==(const_iterator const &rhs) const override;
 
     PermSet const &factors() const
     { return _current_factors; }
 
+    // elements are enumerated such that the transversal factors of deeper
+    // stabilizer chain levels change faster, skip all remaining elements whose
+    // factors up to and including level i coincide with the current element's
+    void skip(unsigned i);
+
   private:
     reference current() override;
     void next() override;
@@ -76,42 +86,24 @@ public:
   PermGroup(unsigned degree, PermSet const &generators);
 
   static PermGroup symmetric(unsigned degree);
+  static PermGroup alternating(unsigned degree);
   static PermGroup cyclic(unsigned degree);
   static PermGroup dihedral(unsigned degree);
 
   template<typename IT>
   static PermGroup direct_product(IT first,
                                   IT last,
-                                  BSGSOptions const *bsgs_options_ = nullptr,
-                                  timeout::flag aborted = timeout::unset())
+                                  BSGSOptions const *bsgs_options = nullptr,
+                                  timeout::flag = timeout::unset())
   {
     assert(std::distance(first, last) > 0);
 
-    // direct product degree
-    unsigned dp_degree = 0u;
-
+    // the direct product's BSGS is assembled from the factors' BSGSs
+    std::vector<BSGS> factors;
     for (auto it = first; it != last; ++it)
-      dp_degree += it->degree();
-
-    // direct product order
-    auto dp_order(direct_product_order(first, last));
-
-    // direct product generators
-    unsigned d = 0u;
-
-    PermSet dp_generators;
-    for (auto it = first; it != last; ++it) {
-      for (Perm const &perm : it->generators())
-        dp_generators.insert(perm.shifted(d).extended(dp_degree));
-
-      d += it->degree();
-    }
+      factors.push_back(it->bsgs());
 
-    // construct direct product
-    auto bsgs_options(BSGSOptions::fill_defaults(bsgs_options_));
-    bsgs_options.schreier_sims_random_known_order = dp_order;
-
-    return PermGroup(BSGS(dp_degree, dp_generators, &bsgs_options, aborted));
+    return PermGroup(BSGS::direct_product(factors, bsgs_options));
   }
 
   template<typename IT>
@@ -144,9 +136,21 @@ public:
 
   PermSet generators() const { return _bsgs.strong_generators(); }
 
-  BSGS &bsgs() { return _bsgs; }
+  BSGS &bsgs()
+  {
+    _base_change_cache.clear();
+    return _bsgs;
+  }
+
   BSGS const &bsgs() const { return _bsgs; }
 
+  // BSGS of this group whose base starts with prefix, BSGSs for the most
+  // recently requested prefixes are cached, the cache may be accessed
+  // concurrently and the returned BSGS remains valid after being evicted from
+  // it (but not after the group itself is modified or destroyed)
+  std::shared_ptr<BSGS const> bsgs(std::vector<unsigned> const &prefix,
+                                   BSGSOptions const *bsgs_options = nullptr) const;
+
   unsigned degree() const { return _bsgs.degree(); }
   BSGS::order_type order() const { return _order; }
 
@@ -165,10 +169,18 @@ public:
   bool is_transitive() const;
 
   bool contains_element(Perm const &perm) const;
-  Perm random_element() const;
+  std::vector<bool> contains_elements(std::vector<Perm> const &perms,
+                                      unsigned num_threads = 1u) const;
+  Perm random_element(util::random_engine_type *re = nullptr) const;
+
+  PermGroup closure(PermSet const &generators,
+                    BSGSOptions const *bsgs_options = nullptr,
+                    timeout::flag aborted = timeout::unset()) const;
 
   std::vector<PermGroup> disjoint_decomposition(
-    bool complete = true, bool disjoint_orbit_optimization = false) const;
+    bool complete = true,
+    bool disjoint_orbit_optimization = false,
+    unsigned num_threads = 1u) const;
 
   std::vector<PermGroup> wreath_decomposition() const;
 
@@ -182,6 +194,46 @@ private:
     return ret;
   }
 
+  // base change cache
+  struct BaseChangeCache
+  {
+    BaseChangeCache() = default;
+
+    BaseChangeCache(BaseChangeCache const &other)
+    {
+      std::lock_guard<std::mutex> lock(other.mutex);
+      entries = other.entries;
+    }
+
+    BaseChangeCache &operator=(BaseChangeCache const &other)
+    {
+      if (this != &other) {
+        std::lock(mutex, other.mutex);
+        std::lock_guard<std::mutex> lock(mutex, std::adopt_lock);
+        std::lock_guard<std::mutex> lock_other(other.mutex, std::adopt_lock);
+        entries = other.entries;
+      }
+
+      return *this;
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      entries.clear();
+    }
+
+    std::list<std::shared_ptr<BSGS const>> entries;
+    mutable std::mutex mutex;
+  };
+
+  std::shared_ptr<BSGS const> base_change_cache_find(
+    std::vector<unsigned> const &prefix,
+    std::shared_ptr<BSGS const> *closest = nullptr) const;
+
+  static std::size_t base_prefix_common(BSGS const &bsgs,
+                                        std::vector<unsigned> const &prefix);
+
   // complete disjoint decomposition
   bool disjoint_decomp_orbits_dependent(
     Orbit const &orbit1,
@@ -190,10 +242,16 @@ private:
   void disjoint_decomp_generate_dependency_classes(
     OrbitPartition &orbits) const;
 
+  static OrbitPartition disjoint_decomp_orbit_split(
+    OrbitPartition const &orbits,
+    unsigned degree,
+    unsigned long long part);
+
   static bool disjoint_decomp_restricted_subgroups(
     OrbitPartition const &orbit_split,
     PermGroup const &perm_group,
-    std::pair<PermGroup, PermGroup> &restricted_subgroups);
+    std::pair<PermGroup, PermGroup> &restricted_subgroups,
+    unsigned num_threads = 1u);
 
   static std::vector<PermGroup> disjoint_decomp_join_results(
     std::vector<PermGroup> const &res1,
@@ -201,10 +259,12 @@ private:
 
   static std::vector<PermGroup> disjoint_decomp_complete_recursive(
     OrbitPartition const &orbits,
-    PermGroup const &perm_group);
+    PermGroup const &perm_group,
+    unsigned num_threads = 1u);
 
   std::vector<PermGroup> disjoint_decomp_complete(
-    bool disjoint_orbit_optimization = true) const;
+    bool disjoint_orbit_optimization = true,
+    unsigned num_threads = 1u) const;
 
   // incomplete disjoint decomposition
   struct MovedSet : public std::vector<unsigned>
@@ -248,8 +308,15 @@ private:
     PermGroup const &block_permuter,
     PermSet const &block_permuter_image) const;
 
+  bool wreath_decomp_verify(
+    PermGroup const &block_permuter_image,
+    std::vector<PermGroup> const &stabilizers) const;
+
   BSGS _bsgs;
   BSGS::order_type _order;
+
+  static constexpr unsigned base_change_cache_size = 8u;
+  mutable BaseChangeCache _base_change_cache;
 };
 
 std::ostream &operator<<(std::ostream &os, PermGroup const &pg);
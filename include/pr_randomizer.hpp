@@ -2,6 +2,7 @@
 #define GUARD_PR_RANDOMIZER_H
 
 #include "perm_set.hpp"
+#include "random.hpp"
 
 namespace mpsym
 {
@@ -15,6 +16,7 @@ class PrRandomizer
 {
 public:
   PrRandomizer(PermSet const &generators,
+               util::random_engine_type *re = nullptr,
                unsigned n_generators = 10,
                unsigned iterations = 20);
 
@@ -26,6 +28,8 @@ private:
   bool test_altsym(double epsilon);
   bool generators_even();
 
+  util::random_engine_type *_re;
+
   PermSet _gens_orig;
   PermSet _gens;
 };
@@ -9,8 +9,23 @@ namespace mpsym
 namespace util
 {
 
-inline std::mt19937 random_engine()
-{ return std::mt19937{std::random_device{}()}; }
+using random_engine_type = std::mt19937;
+
+inline random_engine_type random_engine()
+{ return random_engine_type{std::random_device{}()}; }
+
+inline random_engine_type random_engine(random_engine_type::result_type seed)
+{ return random_engine_type{seed}; }
+
+// randomly seeded engine private to the calling thread
+inline random_engine_type &thread_random_engine()
+{
+  static thread_local auto re(random_engine());
+  return re;
+}
+
+inline random_engine_type &random_engine_or_default(random_engine_type *re)
+{ return re ? *re : thread_random_engine(); }
 
 } // namespace util
 
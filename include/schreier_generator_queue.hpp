@@ -2,10 +2,16 @@
 #define GUARD_SCHREIER_GENERATOR_QUEUE_H
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
+#include <random>
+#include <unordered_set>
 #include <vector>
 
+#include "orbit.hpp"
 #include "perm.hpp"
+#include "perm_set.hpp"
+#include "random.hpp"
 #include "schreier_structure.hpp"
 #include "util.hpp"
 
@@ -60,8 +66,16 @@ public:
     bool _end;
   };
 
-  SchreierGeneratorQueue()
-  : _valid(false)
+  // if 'dedupe' is set, Schreier generators that have already been returned
+  // since the queue's construction are skipped, if 'subset' is non-zero, only
+  // that many randomly chosen Schreier generators are considered per update
+  SchreierGeneratorQueue(bool dedupe = false,
+                         unsigned subset = 0u,
+                         util::random_engine_type *re = nullptr)
+  : _dedupe(dedupe),
+    _subset(subset),
+    _re(re),
+    _valid(false)
   {}
 
   void update(sg_type const &strong_generators,
@@ -76,15 +90,22 @@ public:
     _sg_end = strong_generators.end();
 
     _beta_it = fundamental_orbit.begin();
+    _beta_begin = _beta_it;
     _beta_end = fundamental_orbit.end();
 
     _schreier_structure = schreier_structure;
 
-    _u_beta = u_beta();
-
     _valid = true;
     _used = false;
     _exhausted = _sg_it == _sg_end;
+
+    if (_subset > 0u) {
+      _remaining = _subset;
+      if (!_exhausted)
+        next_random();
+    } else {
+      _u_beta = u_beta();
+    }
   }
 
   void invalidate() { _valid = false; }
@@ -101,10 +122,34 @@ private:
 
   void next_sg()
   {
-    if (++_sg_it == _sg_end)
+    if (_subset > 0u)
+      next_random();
+    else if (++_sg_it == _sg_end)
       next_beta();
   }
 
+  void next_random()
+  {
+    auto &re(util::random_engine_or_default(_re));
+
+    if (_remaining == 0u) {
+      _exhausted = true;
+      return;
+    }
+
+    --_remaining;
+
+    std::uniform_int_distribution<std::ptrdiff_t> d_sg(
+      0, (_sg_end - _sg_begin) - 1);
+    std::uniform_int_distribution<std::ptrdiff_t> d_beta(
+      0, (_beta_end - _beta_begin) - 1);
+
+    _sg_it = _sg_begin + d_sg(re);
+    _beta_it = _beta_begin + d_beta(re);
+
+    _u_beta = u_beta();
+  }
+
   void next_beta()
   {
     if (++_beta_it == _beta_end) {
@@ -120,13 +165,24 @@ private:
     if (_used)
       next_sg();
 
-    while (!_exhausted && _schreier_structure->incoming(*_beta_it, *_sg_it))
-      next_sg();
+    for (;;) {
+      // Schreier generators corresponding to edges in the Schreier structure
+      // are trivial by construction
+      while (!_exhausted && _schreier_structure->incoming(*_beta_it, *_sg_it))
+        next_sg();
 
-    if (_exhausted)
-      return;
+      if (_exhausted)
+        return;
 
-    _schreier_generator = _u_beta * (*_sg_it) * ~u_beta_x();
+      _schreier_generator = _u_beta * (*_sg_it) * ~u_beta_x();
+
+      if (!_schreier_generator.id() &&
+          (!_dedupe || _seen.insert(_schreier_generator).second)) {
+        return;
+      }
+
+      next_sg();
+    }
   }
 
   void mark_used() { _used = true; }
@@ -136,10 +192,18 @@ private:
   sg_it_type _sg_end;
 
   fo_it_type _beta_it;
+  fo_it_type _beta_begin;
   fo_it_type _beta_end;
 
   std::shared_ptr<SchreierStructure> _schreier_structure;
 
+  bool _dedupe;
+  std::unordered_set<Perm> _seen;
+
+  unsigned _subset;
+  unsigned _remaining;
+  util::random_engine_type *_re;
+
   bool _valid;
   bool _used;
   bool _exhausted;
@@ -1,9 +1,13 @@
 #ifndef GUARD_SCHREIER_STRUCTURE_H
 #define GUARD_SCHREIER_STRUCTURE_H
 
+#include <cassert>
+#include <memory>
 #include <ostream>
 #include <vector>
 
+#include "perm_set.hpp"
+
 namespace mpsym
 {
 
@@ -11,7 +15,6 @@ namespace internal
 {
 
 class Perm;
-class PermSet;
 class SchreierStructure;
 
 struct SchreierStructure
@@ -28,14 +31,41 @@ struct SchreierStructure
 
   virtual unsigned root() const = 0;
   virtual std::vector<unsigned> nodes() const = 0;
+  virtual unsigned size() const = 0;
   virtual PermSet labels() const = 0;
 
   virtual bool contains(unsigned node) const = 0;
   virtual bool incoming(unsigned node, Perm const &edge) const = 0;
   virtual Perm transversal(unsigned origin) const = 0;
 
+  // labels fixing the orbit pointwise are never used as edge labels, they are
+  // only stored so that labels() generates the whole stabilizer, the first
+  // num_labels elements of the given set are used which makes it possible for
+  // several structures to share (prefixes of) the same set
+  void share_labels_fixing_orbit(std::shared_ptr<PermSet const> const &labels,
+                                 unsigned num_labels)
+  {
+    assert(num_labels <= labels->size());
+
+    _labels_fixing_orbit = labels;
+    _num_labels_fixing_orbit = num_labels;
+  }
+
+protected:
+  void insert_labels_fixing_orbit(PermSet &labels) const
+  {
+    if (!_labels_fixing_orbit)
+      return;
+
+    labels.insert(_labels_fixing_orbit->begin(),
+                  _labels_fixing_orbit->begin() + _num_labels_fixing_orbit);
+  }
+
 private:
   virtual void dump(std::ostream& os) const = 0;
+
+  std::shared_ptr<PermSet const> _labels_fixing_orbit;
+  unsigned _num_labels_fixing_orbit = 0u;
 };
 
 inline std::ostream &operator<<(std::ostream &os, SchreierStructure const &ss)
@@ -34,6 +34,7 @@ struct SchreierTree : public SchreierStructure
 
   unsigned root() const override;
   std::vector<unsigned> nodes() const override;
+  unsigned size() const override;
   PermSet labels() const override;
 
   bool contains(unsigned node) const override;
@@ -27,10 +27,10 @@ public:
   {}
 
   TaskMapping(std::vector<unsigned> tasks)
-  : std::vector<unsigned>(tasks)
+  : std::vector<unsigned>(std::move(tasks))
   {}
 
-  bool less_than(TaskMapping const other) const
+  bool less_than(TaskMapping const &other) const
   {
     assert(size() == other.size());
 
@@ -48,7 +48,7 @@ public:
   }
 
   template<typename PERM>
-  bool less_than(TaskMapping const other,
+  bool less_than(TaskMapping const &other,
                  PERM const &perm,
                  unsigned offset = 0u) const
   {
@@ -71,6 +71,40 @@ public:
     );
   }
 
+  // lexicographically compares the image of this mapping under perm with
+  // other, the result is negative if the image is smaller, positive if it is
+  // larger and zero if both are equal, position is set to the first position
+  // in which they differ
+  template<typename PERM>
+  int compare(TaskMapping const &other,
+              PERM const &perm,
+              unsigned offset = 0u,
+              unsigned *position = nullptr) const
+  {
+    int res = 0;
+
+    foreach_permuted_task(
+      perm,
+      offset,
+      [&](unsigned i, unsigned, unsigned task_permuted, bool &flag){
+        unsigned task_other = other[i];
+
+        if (task_permuted == task_other)
+          return false;
+
+        res = task_permuted < task_other ? -1 : 1;
+        flag = res < 0;
+
+        if (position)
+          *position = i;
+
+        return true;
+      }
+    );
+
+    return res;
+  }
+
   template<typename PERM>
   void permute(PERM const &perm,
                unsigned offset = 0u,
@@ -97,24 +131,25 @@ public:
                        unsigned offset = 0u,
                        bool *modified = nullptr) const
   {
-    TaskMapping res(*this);
+    TaskMapping res;
+    permuted_into(res, perm, offset, modified);
 
-    if (modified)
-      *modified = false;
-
-    foreach_permuted_task(
-      perm,
-      offset,
-      [&](unsigned i, unsigned task, unsigned task_permuted, bool &){
-        if (modified && task_permuted != task)
-          *modified = true;
+    return res;
+  }
 
-        res[i] = task_permuted;
-        return false;
-      }
-    );
+  // like permuted but stores the image of this mapping in res, which does not
+  // allocate if res already has sufficient capacity, this makes it possible
+  // to reuse the same buffer when permuting a mapping many times
+  template<typename PERM>
+  void permuted_into(TaskMapping &res,
+                     PERM const &perm,
+                     unsigned offset = 0u,
+                     bool *modified = nullptr) const
+  {
+    assert(&res != this);
 
-    return res;
+    res.assign(begin(), end());
+    res.permute(perm, offset, modified);
   }
 
 private:
@@ -126,10 +161,13 @@ private:
   {
     for (auto i = 0u; i < size(); ++i) {
       unsigned task = (*this)[i];
-      if (task < offset || task >= degree + offset)
+
+      // tasks below offset wrap around and thus also fail this check
+      unsigned task_shifted = task - offset;
+      if (task_shifted >= degree)
         continue;
 
-      unsigned task_permuted = perm(task - offset) + offset;
+      unsigned task_permuted = perm(task_shifted) + offset;
 
       bool flag;
       if (func(i, task, task_permuted, flag))
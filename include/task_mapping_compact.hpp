@@ -0,0 +1,268 @@
+#ifndef GUARD_TASK_MAPPING_COMPACT_H
+#define GUARD_TASK_MAPPING_COMPACT_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#include "perm.hpp"
+#include "task_mapping.hpp"
+#include "util.hpp"
+
+namespace mpsym
+{
+
+// task mapping of fixed maximum length whose tasks are stored in 8 or 16 bit
+// lanes in an inline (16 byte aligned) array instead of on the heap, lanes
+// behind the last task are always zero which makes it possible to compare
+// mappings chunk-wise using SIMD instructions (where available), mappings are
+// constructed from TaskMapping objects (which is only possible if they are
+// short enough and all tasks fit into a lane) and can be converted back via
+// to_task_mapping, by default a mapping occupies a single cache line
+template<typename LANE, unsigned CAPACITY = 64u / sizeof(LANE)>
+class CompactTaskMapping
+{
+  static_assert(std::is_same<LANE, uint8_t>::value ||
+                std::is_same<LANE, uint16_t>::value,
+                "lanes must be either 8 or 16 bit wide");
+
+  static_assert((CAPACITY * sizeof(LANE)) % 16u == 0u,
+                "capacity must be a multiple of 16 bytes");
+
+  static constexpr unsigned chunk_bytes = 16u;
+  static constexpr unsigned capacity_bytes = CAPACITY * sizeof(LANE);
+
+public:
+  using lane_type = LANE;
+
+  static constexpr unsigned capacity = CAPACITY;
+  static constexpr unsigned task_max = std::numeric_limits<LANE>::max();
+
+  CompactTaskMapping()
+  : _size(0u)
+  { _lanes.fill(0u); }
+
+  explicit CompactTaskMapping(TaskMapping const &mapping)
+  : _size(static_cast<unsigned>(mapping.size()))
+  {
+    if (!fits(mapping))
+      throw std::invalid_argument("mapping does not fit into compact mapping");
+
+    _lanes.fill(0u);
+
+    for (unsigned i = 0u; i < _size; ++i)
+      _lanes[i] = static_cast<LANE>(mapping[i]);
+  }
+
+  static bool fits(TaskMapping const &mapping)
+  {
+    if (mapping.size() > CAPACITY)
+      return false;
+
+    return std::all_of(mapping.begin(),
+                       mapping.end(),
+                       [](unsigned task){ return task <= task_max; });
+  }
+
+  TaskMapping to_task_mapping() const
+  { return TaskMapping(std::vector<unsigned>(begin(), end())); }
+
+  unsigned size() const
+  { return _size; }
+
+  unsigned operator[](unsigned i) const
+  {
+    assert(i < _size);
+    return _lanes[i];
+  }
+
+  LANE const *begin() const
+  { return _lanes.data(); }
+
+  LANE const *end() const
+  { return _lanes.data() + _size; }
+
+  bool operator==(CompactTaskMapping const &other) const
+  {
+    return _size == other._size &&
+           std::memcmp(_lanes.data(), other._lanes.data(), capacity_bytes) == 0;
+  }
+
+  bool operator!=(CompactTaskMapping const &other) const
+  { return !(*this == other); }
+
+  // lexicographic comparison, the first differing lane is located by comparing
+  // whole chunks of lanes at once
+  bool less_than(CompactTaskMapping const &other) const
+  {
+    assert(_size == other._size);
+
+#if defined(__SSE2__) && defined(__GNUC__)
+    unsigned size_bytes = _size * sizeof(LANE);
+
+    for (unsigned offset = 0u; offset < size_bytes; offset += chunk_bytes) {
+      __m128i chunk = load_chunk(offset);
+      __m128i chunk_other = other.load_chunk(offset);
+
+      unsigned mask = ~static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, chunk_other))) & 0xFFFFu;
+
+      if (mask) {
+        unsigned i = (offset + __builtin_ctz(mask)) / sizeof(LANE);
+        return _lanes[i] < other._lanes[i];
+      }
+    }
+
+    return false;
+#else
+    for (unsigned i = 0u; i < _size; ++i) {
+      if (_lanes[i] != other._lanes[i])
+        return _lanes[i] < other._lanes[i];
+    }
+
+    return false;
+#endif
+  }
+
+  // tasks in [offset, offset + perm.degree()) are replaced by their images
+  // under perm (shifted by offset), all other tasks are left unchanged, these
+  // images must fit into a lane, for 8 bit lanes and permutations acting on at
+  // most 16 tasks (including offset) the images of all lanes in a chunk are
+  // looked up at once via a byte shuffle (requires SSSE3), otherwise the lanes
+  // are permuted by a branch free gather which is simple enough to be auto
+  // vectorized
+  void permute(internal::Perm const &perm, unsigned offset = 0u)
+  {
+    unsigned degree = perm.degree();
+
+    assert(offset + degree - 1u <= task_max);
+
+#if defined(__SSSE3__)
+    if (sizeof(LANE) == 1u && offset + degree <= chunk_bytes) {
+      permute_shuffle(perm, offset);
+      return;
+    }
+#endif
+
+    for (unsigned i = 0u; i < _size; ++i) {
+      unsigned task = _lanes[i];
+      unsigned task_shifted = task - offset;
+
+      unsigned task_permuted =
+        task_shifted < degree ? perm[task_shifted] + offset : task;
+
+      _lanes[i] = static_cast<LANE>(task_permuted);
+    }
+  }
+
+  CompactTaskMapping permuted(internal::Perm const &perm,
+                              unsigned offset = 0u) const
+  {
+    CompactTaskMapping res(*this);
+    res.permute(perm, offset);
+
+    return res;
+  }
+
+private:
+#if defined(__SSE2__) && defined(__GNUC__)
+  __m128i load_chunk(unsigned offset) const
+  {
+    return _mm_load_si128(reinterpret_cast<__m128i const *>(
+      reinterpret_cast<char const *>(_lanes.data()) + offset));
+  }
+#endif
+
+#if defined(__SSSE3__)
+  void permute_shuffle(internal::Perm const &perm, unsigned offset)
+  {
+    alignas(16) std::array<uint8_t, chunk_bytes> table;
+
+    for (unsigned task = 0u; task < chunk_bytes; ++task) {
+      unsigned task_shifted = task - offset;
+
+      table[task] = static_cast<uint8_t>(
+        task_shifted < perm.degree() ? perm[task_shifted] + offset : task);
+    }
+
+    __m128i table_chunk =
+      _mm_load_si128(reinterpret_cast<__m128i const *>(table.data()));
+
+    __m128i high_nibble = _mm_set1_epi8(static_cast<char>(0xF0));
+
+    for (unsigned offset_bytes = 0u;
+         offset_bytes < _size;
+         offset_bytes += chunk_bytes) {
+
+      auto chunk_ptr = reinterpret_cast<__m128i *>(_lanes.data() + offset_bytes);
+
+      __m128i chunk = _mm_load_si128(chunk_ptr);
+
+      // lanes holding tasks larger than 15 are not looked up in the table
+      __m128i in_table = _mm_cmpeq_epi8(_mm_and_si128(chunk, high_nibble),
+                                        _mm_setzero_si128());
+
+      __m128i chunk_permuted = _mm_shuffle_epi8(table_chunk, chunk);
+
+      _mm_store_si128(chunk_ptr,
+                      _mm_or_si128(_mm_and_si128(in_table, chunk_permuted),
+                                   _mm_andnot_si128(in_table, chunk)));
+    }
+
+    // lanes behind the last task might have been changed in the last chunk
+    std::fill(_lanes.begin() + _size, _lanes.end(), 0u);
+  }
+#endif
+
+  alignas(16) std::array<LANE, CAPACITY> _lanes;
+  unsigned _size;
+};
+
+template<typename LANE, unsigned CAPACITY>
+constexpr unsigned CompactTaskMapping<LANE, CAPACITY>::capacity;
+
+template<typename LANE, unsigned CAPACITY>
+constexpr unsigned CompactTaskMapping<LANE, CAPACITY>::task_max;
+
+using CompactTaskMapping8 = CompactTaskMapping<uint8_t>;
+using CompactTaskMapping16 = CompactTaskMapping<uint16_t>;
+
+template<typename LANE, unsigned CAPACITY>
+std::ostream &operator<<(std::ostream &os,
+                         CompactTaskMapping<LANE, CAPACITY> const &ta)
+{
+  os << ta.to_task_mapping();
+  return os;
+}
+
+} // namespace mpsym
+
+namespace std
+{
+
+template<typename LANE, unsigned CAPACITY>
+struct hash<mpsym::CompactTaskMapping<LANE, CAPACITY>>
+{
+  std::size_t operator()(mpsym::CompactTaskMapping<LANE, CAPACITY> const &ta) const
+  { return mpsym::util::container_hash(ta.begin(), ta.end()); }
+};
+
+} // namespace std
+
+#endif // GUARD_TASK_MAPPING_COMPACT_H
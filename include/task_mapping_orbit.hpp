@@ -2,9 +2,15 @@
 #define GUARD_TASK_MAPPING_ORBIT_H
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -12,6 +18,7 @@
 
 #include "perm_set.hpp"
 #include "task_mapping.hpp"
+#include "task_mapping_orbit_arena.hpp"
 #include "util.hpp"
 
 namespace mpsym
@@ -107,34 +114,61 @@ private:
   internal::PermSet _generators;
 };
 
+// orbit representatives are stored in an arena in which every task is packed
+// into the smallest number of bits able to hold all tasks inserted so far (all
+// representatives thus need to have the same length), representatives are
+// identified by their equivalence class, i.e. their position in the arena, and
+// looked up via an open addressing hash table of such positions, this table is
+// preceded by a blocked bloom filter so that looking up mappings which are not
+// representatives (by far the most common case when matching against known
+// representatives) usually only touches a single cache line, hit/miss
+// statistics of this filter are recorded, iteration proceeds in order of
+// insertion, if constructed from a file name, the arena is kept in that (memory
+// mapped) file instead of in main memory and representatives already contained
+// in the file are loaded on construction, which makes it possible to resume
+// interrupted runs, only the hash table and filter are kept in main memory then
 class TMORs
 {
-  using orbit_reprs_map = std::unordered_map<TaskMapping, unsigned>;
+  using word_type = internal::TMORsArena::word_type;
+  using index_type = uint32_t;
+
+  static constexpr index_type index_empty = UINT32_MAX;
 
 public:
+  struct FilterStats
+  {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t false_positives;
+  };
+
   class const_iterator
-  : public util::Iterator<const_iterator, TaskMapping const>
+  : public util::Iterator<const_iterator, TaskMapping const, true>
   {
   public:
-    const_iterator(orbit_reprs_map::const_iterator const &it)
-    : _it(it)
+    const_iterator(TMORs const *orbits, unsigned equivalence_class)
+    : _orbits(orbits),
+      _equivalence_class(equivalence_class)
     {}
 
     bool operator==(const_iterator const &rhs) const override
-    { return _it == rhs._it; }
+    { return _equivalence_class == rhs._equivalence_class; }
 
   private:
-    reference current() override
-    { return _it->first; }
+    value_type current() override
+    { return _orbits->repr(_equivalence_class); }
 
     void next() override
-    { ++_it; }
+    { ++_equivalence_class; }
 
-    orbit_reprs_map::const_iterator _it;
+    TMORs const *_orbits;
+    unsigned _equivalence_class;
   };
 
-  bool operator==(TMORs const &rhs) const
-  { return orbit_repr_set() == rhs.orbit_repr_set(); }
+  TMORs() = default;
+  explicit TMORs(std::string const &file);
+
+  bool operator==(TMORs const &rhs) const;
 
   bool operator!=(TMORs const &rhs) const
   { return !(*this == rhs); }
@@ -148,33 +182,194 @@ public:
       insert(*it);
   }
 
-  bool is_repr(TaskMapping const &mapping) const
+  bool is_repr(TaskMapping const &mapping) const;
+
+  unsigned num_orbits() const
+  { return _num_orbits; }
+
+  TaskMapping repr(unsigned equivalence_class) const;
+
+  const_iterator begin() const
+  { return const_iterator(this, 0u); }
+
+  const_iterator end() const
+  { return const_iterator(this, _num_orbits); }
+
+  bool file_backed() const
+  { return _arena.file_backed(); }
+
+  void sync() const
+  { _arena.sync(); }
+
+  FilterStats filter_stats() const;
+  void reset_filter_stats() const;
+
+private:
+  struct FilterCounters
   {
-    auto it(_orbit_reprs.find(mapping));
+    FilterCounters()
+    : hits(0u),
+      misses(0u),
+      false_positives(0u)
+    {}
+
+    FilterCounters(FilterCounters const &other)
+    : hits(other.hits.load(std::memory_order_relaxed)),
+      misses(other.misses.load(std::memory_order_relaxed)),
+      false_positives(other.false_positives.load(std::memory_order_relaxed))
+    {}
+
+    FilterCounters &operator=(FilterCounters const &other)
+    {
+      hits.store(other.hits.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+      misses.store(other.misses.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+      false_positives.store(other.false_positives.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+      return *this;
+    }
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> false_positives;
+  };
+
+  void pack(TaskMapping const &mapping, std::vector<word_type> &packed) const;
+  void repack(unsigned task_bits);
 
-    return it != _orbit_reprs.end();
+  // arena offsets easily exceed the range of unsigned for large numbers of
+  // long representatives and are thus computed as std::size_t
+  word_type const *packed_repr(unsigned equivalence_class) const
+  {
+    return _arena.data() +
+           static_cast<std::size_t>(equivalence_class) * _mapping_words;
   }
 
+  uint64_t fingerprint(TaskMapping const &mapping) const;
+  uint64_t fingerprint(word_type const *packed) const;
+
+  std::size_t index_find(TaskMapping const &mapping, uint64_t fp) const;
+  void index_insert(uint64_t fp, index_type equivalence_class);
+  void index_rebuild(unsigned index_bits);
+
+  bool filter_contains(uint64_t fp) const;
+  void filter_insert(uint64_t fp);
+
+  unsigned _mapping_size = 0u;
+  unsigned _task_bits = 0u;
+  unsigned _mapping_words = 0u;
+  internal::TMORsArena _arena;
+
+  unsigned _index_bits = 0u;
+  std::vector<index_type> _index;
+
+  std::vector<uint32_t> _filter;
+  mutable FilterCounters _filter_counters;
+
+  unsigned _num_orbits = 0u;
+};
+
+// TMORs variant that can be modified by several threads at the same time, the
+// representatives are distributed over a number of independently locked
+// shards, equivalence class IDs are still dense but (unless mappings are
+// inserted with sequence numbers, see below) depend on the order in which
+// concurrent insertions happen, iteration must not happen concurrently with
+// insertion
+class ConcurrentTMORs
+{
+  using orbit_reprs_map = std::unordered_map<TaskMapping, unsigned>;
+
+  struct Shard
+  {
+    orbit_reprs_map orbit_reprs;
+    mutable std::mutex mutex;
+  };
+
+public:
+  class const_iterator
+  : public util::Iterator<const_iterator, TaskMapping const>
+  {
+  public:
+    const_iterator(ConcurrentTMORs const *orbits, unsigned shard)
+    : _orbits(orbits),
+      _shard(shard)
+    {
+      if (_shard < _orbits->_shards.size())
+        _it = _orbits->_shards[_shard].orbit_reprs.begin();
+
+      skip_exhausted_shards();
+    }
+
+    bool operator==(const_iterator const &rhs) const override
+    {
+      return _shard == rhs._shard &&
+             (_shard == _orbits->_shards.size() || _it == rhs._it);
+    }
+
+  private:
+    reference current() override
+    { return _it->first; }
+
+    void next() override
+    {
+      ++_it;
+      skip_exhausted_shards();
+    }
+
+    void skip_exhausted_shards()
+    {
+      auto const &shards(_orbits->_shards);
+
+      while (_shard < shards.size() &&
+             _it == shards[_shard].orbit_reprs.end()) {
+        if (++_shard < shards.size())
+          _it = shards[_shard].orbit_reprs.begin();
+      }
+    }
+
+    ConcurrentTMORs const *_orbits;
+    unsigned _shard;
+    orbit_reprs_map::const_iterator _it;
+  };
+
+  // the number of shards is rounded up to the next power of two
+  explicit ConcurrentTMORs(unsigned num_shards = 64u);
+
+  std::pair<bool, unsigned> insert(TaskMapping const &mapping);
+
+  // like insert but blocks until all mappings with smaller sequence numbers
+  // have been inserted, if all mappings are inserted like this with sequence
+  // numbers 0, 1, 2, ... (no number may be skipped), equivalence class IDs are
+  // the same as those assigned by TMORs::insert when inserting the mappings in
+  // order of their sequence numbers, independent of the number of threads,
+  // this overload should not be mixed with the one above
+  std::pair<bool, unsigned> insert(TaskMapping const &mapping,
+                                   std::size_t sequence_number);
+
+  bool is_repr(TaskMapping const &mapping) const;
+
   unsigned num_orbits() const
-  { return static_cast<unsigned>(_orbit_reprs.size()); }
+  { return _num_orbits.load(std::memory_order_acquire); }
 
   const_iterator begin() const
-  { return const_iterator(_orbit_reprs.begin()); }
+  { return const_iterator(this, 0u); }
 
   const_iterator end() const
-  { return const_iterator(_orbit_reprs.end()); }
+  { return const_iterator(this, static_cast<unsigned>(_shards.size())); }
 
 private:
-  std::unordered_set<TaskMapping> orbit_repr_set() const
-  {
-    std::unordered_set<TaskMapping> ret;
-    for (auto const &repr : _orbit_reprs)
-      ret.insert(repr.first);
+  static unsigned shard_bits(unsigned num_shards);
+  std::size_t shard_index(TaskMapping const &mapping) const;
 
-    return ret;
-  }
+  unsigned _shard_bits;
+  std::vector<Shard> _shards;
+
+  std::atomic<unsigned> _num_orbits;
 
-  orbit_reprs_map _orbit_reprs;
+  std::size_t _sequence_next;
+  std::mutex _sequence_mutex;
+  std::condition_variable _sequence_cv;
 };
 
 } // namespace mpsym
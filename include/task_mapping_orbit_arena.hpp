@@ -0,0 +1,118 @@
+#ifndef GUARD_TASK_MAPPING_ORBIT_ARENA_H
+#define GUARD_TASK_MAPPING_ORBIT_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+// storage backing TMORs, either a plain vector or an append-only file which is
+// memory mapped and thus paged in lazily, in the latter case all data and
+// metadata is kept in the file so that an interrupted run can later be resumed
+// by opening the same file again, data is appended behind the last committed
+// word and only becomes visible once commit has updated the file header, so a
+// crash never leaves a partially written representative behind, replacing the
+// arena's contents (which happens when tasks have to be widened) writes a
+// temporary file which is then atomically renamed, copies of a file backed
+// arena are held in memory
+class TMORsArena
+{
+public:
+  using word_type = uint64_t;
+
+  TMORsArena() = default;
+  explicit TMORsArena(std::string const &file);
+
+  TMORsArena(TMORsArena const &other);
+  TMORsArena(TMORsArena &&other) noexcept;
+
+  TMORsArena &operator=(TMORsArena other) noexcept;
+
+  ~TMORsArena();
+
+  void swap(TMORsArena &other) noexcept;
+
+  bool file_backed() const
+  { return _fd != -1; }
+
+  std::string const &file() const
+  { return _file; }
+
+  word_type *data();
+  word_type const *data() const;
+
+  std::size_t size() const
+  { return _header.num_words; }
+
+  unsigned mapping_size() const
+  { return static_cast<unsigned>(_header.mapping_size); }
+
+  unsigned task_bits() const
+  { return static_cast<unsigned>(_header.task_bits); }
+
+  unsigned num_orbits() const
+  { return static_cast<unsigned>(_header.num_orbits); }
+
+  void append(word_type const *first, word_type const *last);
+
+  void commit(unsigned mapping_size, unsigned task_bits, unsigned num_orbits);
+
+  // discards all (committed and uncommitted) words behind the first num_words
+  void truncate(std::size_t num_words);
+
+  // empty arena which is file backed (by a temporary file) if and only if this
+  // arena is, it can be filled via append and then passed to replace, this way
+  // the new contents never have to be held in memory as a whole
+  TMORsArena replacement() const;
+
+  void replace(TMORsArena replacement,
+               unsigned mapping_size,
+               unsigned task_bits,
+               unsigned num_orbits);
+
+  void sync() const;
+
+private:
+  struct Header
+  {
+    uint64_t magic = 0u;
+    uint64_t version = 0u;
+    uint64_t mapping_size = 0u;
+    uint64_t task_bits = 0u;
+    uint64_t num_orbits = 0u;
+    uint64_t num_words = 0u;
+  };
+
+  static constexpr uint64_t file_magic = UINT64_C(0x4f4d54594d53504d);
+  static constexpr uint64_t file_version = 1u;
+
+  void open(std::string const &file);
+  void close() noexcept;
+
+  void map(std::size_t file_size);
+  void reserve(std::size_t num_words);
+
+  Header *mapped_header() const
+  { return reinterpret_cast<Header *>(_map); }
+
+  Header _header;
+  std::vector<word_type> _words;
+
+  std::string _file;
+  int _fd = -1;
+  char *_map = nullptr;
+  std::size_t _map_size = 0u;
+  std::size_t _num_words_uncommitted = 0u;
+};
+
+} // namespace internal
+
+} // namespace mpsym
+
+#endif // GUARD_TASK_MAPPING_ORBIT_ARENA_H
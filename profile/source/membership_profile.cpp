@@ -0,0 +1,261 @@
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+#include <libgen.h>
+
+#include "perm.hpp"
+#include "perm_group.hpp"
+#include "perm_set.hpp"
+#include "util.hpp"
+
+#include "profile_args.hpp"
+#include "profile_parse.hpp"
+#include "profile_read.hpp"
+#include "profile_run.hpp"
+#include "profile_util.hpp"
+
+using namespace profile;
+
+namespace
+{
+
+std::string progname;
+
+void usage(std::ostream &s)
+{
+  char const *opts[] = {
+    "[-h|--help]",
+    "-m|--method {single|batched}",
+    "-g|--groups GROUPS",
+    "[-n|--num-candidates NUM_CANDIDATES]",
+    "[-j|--num-threads NUM_THREADS]",
+    "[-r|--num-runs NUM_RUNS]",
+    "[--num-discarded-runs NUM_DISCARDED_RUNS]",
+    "[--summarize-runs]",
+    "[-v|--verbose]"
+  };
+
+  s << "usage: " << progname << '\n';
+  for (char const *opt : opts)
+    s << "  " << opt << '\n';
+}
+
+struct ProfileOptions
+{
+  VariantOption method{"single", "batched"};
+
+  unsigned num_candidates = 10000u;
+  unsigned num_threads = 1u;
+  unsigned num_runs = 1u;
+  unsigned num_discarded_runs = 0u;
+  bool summarize_runs = false;
+  bool verbose = false;
+};
+
+std::vector<mpsym::internal::Perm> make_candidates(
+  mpsym::internal::PermGroup const &group,
+  ProfileOptions const &options)
+{
+  using mpsym::internal::Perm;
+  using mpsym::internal::PermGroup;
+
+  // half of the candidates are group members, the other half are (most likely)
+  // non-members drawn from the symmetric group of the same degree
+  auto symmetric(PermGroup::symmetric(group.degree()));
+
+  std::vector<Perm> candidates;
+  candidates.reserve(options.num_candidates);
+
+  for (unsigned i = 0u; i < options.num_candidates; ++i) {
+    candidates.push_back(i % 2u == 0u ? group.random_element()
+                                      : symmetric.random_element());
+  }
+
+  return candidates;
+}
+
+unsigned contains_elements_single(
+  mpsym::internal::PermGroup const &group,
+  std::vector<mpsym::internal::Perm> const &candidates)
+{
+  unsigned num_members = 0u;
+  for (auto const &candidate : candidates) {
+    if (group.contains_element(candidate))
+      ++num_members;
+  }
+
+  return num_members;
+}
+
+unsigned contains_elements_batched(
+  mpsym::internal::PermGroup const &group,
+  std::vector<mpsym::internal::Perm> const &candidates,
+  ProfileOptions const &options)
+{
+  unsigned num_members = 0u;
+  for (bool member : group.contains_elements(candidates, options.num_threads)) {
+    if (member)
+      ++num_members;
+  }
+
+  return num_members;
+}
+
+std::vector<double> run_group(unsigned degree,
+                              std::string const &generators,
+                              ProfileOptions const &options)
+{
+  using mpsym::internal::PermGroup;
+
+  PermGroup group(parse_generators_mpsym(degree, generators));
+
+  auto candidates(make_candidates(group, options));
+
+  std::vector<double> ts;
+  unsigned num_members;
+
+  if (options.method.is("single")) {
+    num_members = run_cpp([&]{
+                            return contains_elements_single(group, candidates);
+                          },
+                          options.num_discarded_runs,
+                          options.num_runs,
+                          &ts);
+
+  } else if (options.method.is("batched")) {
+    num_members = run_cpp([&]{
+                            return contains_elements_batched(group,
+                                                             candidates,
+                                                             options);
+                          },
+                          options.num_discarded_runs,
+                          options.num_runs,
+                          &ts);
+
+  } else {
+    throw std::logic_error("unreachable");
+  }
+
+  if (options.verbose)
+    info("=> members", num_members, "/", candidates.size());
+
+  return ts;
+}
+
+void do_profile(Stream &groups_stream,
+                ProfileOptions const &options)
+{
+  if (options.verbose) {
+    debug("Method:", options.method.get());
+    debug("Candidates:", options.num_candidates);
+    debug("Threads:", options.num_threads);
+  }
+
+  foreach_line(groups_stream.stream,
+               [&](std::string const &line, unsigned lineno){
+
+    auto group(parse_group(line));
+
+    if (options.verbose) {
+      info("Testing membership for group", lineno);
+      info("=> degree", group.degree);
+      info("=> orders", group.order);
+      info("=> generators", group.generators);
+    } else {
+      info("Testing membership for group", lineno);
+    }
+
+    auto ts(run_group(group.degree, group.generators, options));
+
+    dump_runs(ts, options.summarize_runs);
+  });
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+  using mpsym::util::stox;
+
+  progname = basename(argv[0]);
+
+  struct option long_options[] = {
+    {"help",               no_argument,       0,       'h'},
+    {"method",             required_argument, 0,       'm'},
+    {"groups",             required_argument, 0,       'g'},
+    {"num-candidates",     required_argument, 0,       'n'},
+    {"num-threads",        required_argument, 0,       'j'},
+    {"num-runs",           required_argument, 0,       'r'},
+    {"num-discarded-runs", required_argument, 0,        1 },
+    {"summarize-runs",     no_argument,       0,        2 },
+    {"verbose",            no_argument,       0,       'v'},
+    {nullptr,              0,                 nullptr,  0 }
+  };
+
+  ProfileOptions options;
+
+  Stream groups_stream;
+
+  for (;;) {
+    int c = getopt_long(argc, argv, "hm:g:n:j:r:v", long_options, nullptr);
+    if (c == -1)
+      break;
+
+    try {
+      switch(c) {
+      case 'h':
+        usage(std::cout);
+        return EXIT_SUCCESS;
+      case 'm':
+        options.method.set(optarg);
+        break;
+      case 'g':
+        OPEN_STREAM(groups_stream, optarg);
+        break;
+      case 'n':
+        options.num_candidates = stox<unsigned>(optarg);
+        break;
+      case 'j':
+        options.num_threads = stox<unsigned>(optarg);
+        break;
+      case 'r':
+        options.num_runs = stox<unsigned>(optarg);
+        break;
+      case 1:
+        options.num_discarded_runs = stox<unsigned>(optarg);
+        break;
+      case 2:
+        options.summarize_runs = true;
+        break;
+      case 'v':
+        options.verbose = true;
+        break;
+      default:
+        return EXIT_FAILURE;
+      }
+    } catch (std::invalid_argument const &e) {
+      error("invalid option argument:", e.what());
+      return EXIT_FAILURE;
+    }
+  }
+
+  CHECK_OPTION(options.method.is_set(),
+               "--method option is mandatory");
+
+  CHECK_OPTION(groups_stream.valid,
+               "--groups option is mandatory");
+
+  try {
+    do_profile(groups_stream, options);
+  } catch (std::exception const &e) {
+    error("profiling failed:", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -36,12 +36,13 @@ void usage(std::ostream &s)
   char const *opts[] = {
     "[-h|--help]",
     "-i|--implementation {gap|mpsym}",
-    "-m|--repr-method {iterate|orbits|local_search}",
+    "-m|--repr-method {iterate|orbits|canonical|local_search}",
     "--repr-variant {local_search_bfs|local_search_dfs|local_search_sa_linear}",
     "--repr-local-search-invert-generators",
     "--repr-local-search-append-generators",
     "--repr-local-search-iterations",
     "--repr-local-search-sa-T-init",
+    "[--repr-decomposition {disjoint|wreath|auto}]",
     "[--repr-options {dont_decompose,dont_match,dont_optimize_symmetric}]",
     "[-g|--groups GROUPS]",
     "[-a|--arch-graph ARCH_GRAPH]",
@@ -67,9 +68,10 @@ void usage(std::ostream &s)
 struct ProfileOptions
 {
   VariantOption library{"gap", "mpsym"};
-  VariantOption repr_method{"iterate", "orbits", "local_search"};
+  VariantOption repr_method{"iterate", "orbits", "canonical", "local_search"};
   VariantOption repr_variant{
     "local_search_bfs", "local_search_dfs", "local_search_sa_linear"};
+  VariantOption repr_decomposition{"disjoint", "wreath", "auto"};
   VariantOptionSet repr_options{
     "dont_decompose", "dont_match", "dont_optimize_symmetric"};
 
@@ -134,6 +136,13 @@ for element in automorphisms do
   permuted:=OnTuples(task_mapping, element);
   )");
 
+  if (options.repr_decomposition.is("disjoint"))
+    repr_options.decomposition = ReprOptions::Decomposition::DISJOINT;
+  else if (options.repr_decomposition.is("wreath"))
+    repr_options.decomposition = ReprOptions::Decomposition::WREATH;
+  else if (options.repr_decomposition.is("auto"))
+    repr_options.decomposition = ReprOptions::Decomposition::AUTO;
+
   if (options.repr_options.is_set("dont_match")) {
     ret += R"(
   if permuted < orbit_repr then
@@ -253,6 +262,8 @@ mpsym::ReprOptions map_tasks_mpsym_repr_options(
     repr_options.method = ReprOptions::Method::ITERATE;
   } else if (options.repr_method.is("orbits")) {
     repr_options.method = ReprOptions::Method::ORBITS;
+  } else if (options.repr_method.is("canonical")) {
+    repr_options.method = ReprOptions::Method::CANONICAL;
   } else if (options.repr_method.is("local_search")) {
     repr_options.method = ReprOptions::Method::LOCAL_SEARCH;
 
@@ -387,6 +398,15 @@ void map_tasks_mpsym_wrapper(std::shared_ptr<mpsym::ArchGraphSystem> ags,
     debug_progress_done();
 
     debug("=> Found", task_orbits->num_orbits(), "orbit representatives");
+
+    if (repr_options.match) {
+      auto stats(task_orbits->filter_stats());
+
+      debug("=> Representative filter:", stats.hits, "hits,",
+                                         stats.misses, "misses,",
+                                         stats.false_positives, "false positives");
+    }
+
     if (options.verbosity > 1) {
       for (auto const &repr : *task_orbits)
         debug(DUMP(repr));
@@ -590,6 +610,7 @@ int main(int argc, char **argv)
     {"verbose",                             no_argument,       0,       'v'},
     {"compile-gap",                         no_argument,       0,        11},
     {"show-gap-errors",                     no_argument,       0,        12},
+    {"repr-decomposition",                  required_argument, 0,        13},
     {nullptr,                               0,                 nullptr,  0 }
   };
 
@@ -678,6 +699,9 @@ int main(int argc, char **argv)
       case 12:
         options.show_gap_errors = true;
         break;
+      case 13:
+        options.repr_decomposition.set(optarg);
+        break;
       default:
         return EXIT_FAILURE;
       }
@@ -697,6 +721,10 @@ int main(int argc, char **argv)
   CHECK_OPTION(options.groups_input != options.arch_graph_input,
                "EITHER --arch-graph OR --groups must be given");
 
+  CHECK_OPTION(!options.library.is("gap") ||
+               !options.repr_method.is("canonical"),
+               "--repr-method canonical only available when using mpsym");
+
   CHECK_OPTION(!options.library.is("gap") ||
                !(options.check_accuracy_gap || options.check_accuracy_mpsym),
                "--check-accuracy-* only available when using mpsym");
@@ -200,9 +200,20 @@ class ArchGraphSystemTest(unittest.TestCase):
     def test_representative(self):
         for orbit in [self.ag_orbit1, self.ag_orbit2]:
             for mapping in orbit:
-                for method in 'iterate', 'orbit':
+                for method in 'iterate', 'orbit', 'canonical':
                     self.assertEqual(self.ag.representative(mapping, method=method), orbit[0])
 
+    def test_representatives(self):
+        mappings = self.ag_orbit1 + self.ag_orbit2
+
+        reprs_serial = mp.Representatives()
+        expected = [self.ag.representative(mapping, reprs_serial) for mapping in mappings]
+
+        for num_threads in 1, 2, 4:
+            reprs = mp.Representatives()
+            self.assertEqual(self.ag.representatives(mappings, reprs, num_threads=num_threads), expected)
+            self.assertEqual(reprs, reprs_serial)
+
     def test_orbit(self):
         for orbit in [self.ag_orbit1, self.ag_orbit2]:
             self.assertCountEqual(list(self.ag.orbit(orbit[0])), orbit)
@@ -122,6 +122,8 @@ ReprOptions str_to_repr_options(std::string const &method)
     options.method = ReprOptions::Method::ITERATE;
   } else if (method == "orbit") {
     options.method = ReprOptions::Method::ORBITS;
+  } else if (method == "canonical") {
+    options.method = ReprOptions::Method::CANONICAL;
   } else if (method == "local_search_bfs") {
     options.method = ReprOptions::Method::LOCAL_SEARCH;
     options.variant = ReprOptions::Variant::LOCAL_SEARCH_BFS;
@@ -380,7 +382,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
          {
            using T = TaskMapping(ArchGraphSystem::*)(TaskMapping const &,
                                                      ReprOptions const *,
-                                                     flag);
+                                                     flag) const;
 
            auto options(str_to_repr_options(method));
 
@@ -405,7 +407,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
                      (ArchGraphSystem::*)(TaskMapping const &,
                                           TMORs &,
                                           ReprOptions const *,
-                                          flag);
+                                          flag) const;
 
 
            auto options(str_to_repr_options(method));
@@ -427,7 +429,40 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
                                   orbit_new,
                                   orbit_index);
          },
-         "mapping"_a, "representatives"_a, "method"_a = "auto", "timeout"_a = 0.0);
+         "mapping"_a, "representatives"_a, "method"_a = "auto", "timeout"_a = 0.0)
+    .def("representatives",
+         [&](ArchGraphSystem &self,
+             Sequence<Sequence<>> const &mappings,
+             TMORs &representatives,
+             std::string const &method,
+             unsigned num_threads,
+             double timeout)
+         {
+           auto options(str_to_repr_options(method));
+
+           auto reprs(arch_graph_timeout("representatives",
+                                         timeout,
+                                         self,
+                                         &ArchGraphSystem::repr_batch,
+                                         Sequence<TaskMapping>(mappings.begin(),
+                                                               mappings.end()),
+                                         representatives,
+                                         &options,
+                                         num_threads));
+
+           std::vector<std::tuple<py::tuple, bool, unsigned>> res;
+           res.reserve(reprs.size());
+
+           for (auto const &repr : reprs) {
+             res.emplace_back(to_tuple(std::get<0>(repr)),
+                              std::get<1>(repr),
+                              std::get<2>(repr));
+           }
+
+           return res;
+         },
+         "mappings"_a, "representatives"_a, "method"_a = "auto",
+         "num_threads"_a = 1u, "timeout"_a = 0.0);
 
   // ArchGraphAutomorphisms
   py::class_<ArchGraphAutomorphisms,
@@ -596,6 +631,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
   // TMORs
   py::class_<TMORs>(m, "Representatives")
     .def(py::init<>())
+    .def(py::init<std::string const &>(), "file"_a)
     .def(py::self == py::self)
     .def(py::self != py::self)
     .def("__len__", &TMORs::num_orbits)
@@ -606,7 +642,8 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
     .def("__contains__",
          [](TMORs const &orbits, Sequence<> const &mapping)
          { return orbits.is_repr(mapping); },
-         "mapping"_a);
+         "mapping"_a)
+    .def("sync", &TMORs::sync);
 
   // Perm
   py::class_<Perm>(m, "Perm")
@@ -733,6 +770,7 @@ PYBIND11_MODULE_(PYTHON_MODULE_INTERNAL, m)
            }),
          "degree"_a, "generators"_a)
     .def_static("symmetric", PermGroup::symmetric, "degree"_a)
+    .def_static("alternating", PermGroup::alternating, "degree"_a)
     .def_static("cyclic", PermGroup::cyclic, "degree"_a)
     .def_static("dihedral", PermGroup::dihedral, "degree"_a)
     .def_static("direct_product",
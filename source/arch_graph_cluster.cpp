@@ -7,6 +7,7 @@
 #include "arch_graph_cluster.hpp"
 #include "arch_graph_system.hpp"
 #include "dump.hpp"
+#include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
 #include "task_mapping.hpp"
@@ -47,6 +48,32 @@ ArchGraphCluster::to_json() const
   return ss.str();
 }
 
+void
+ArchGraphCluster::add_subsystem(std::shared_ptr<ArchGraphSystem> subsystem)
+{
+  if (automorphisms_ready() && subsystem->automorphisms_ready()) {
+    // a new subsystem only adds symmetries, so the current automorphism group
+    // can be extended instead of being recomputed from scratch
+    unsigned degree = automorphisms().degree();
+
+    auto automorphisms_subsystem(subsystem->automorphisms());
+
+    PermSet generators;
+    for (Perm const &gen : automorphisms_subsystem.generators())
+      generators.insert(gen.shifted(degree));
+
+    if (generators.empty())
+      generators.insert(Perm(degree + automorphisms_subsystem.degree()));
+
+    extend_automorphisms(generators);
+
+  } else {
+    reset_automorphisms();
+  }
+
+  _subsystems.push_back(subsystem);
+}
+
 unsigned
 ArchGraphCluster::num_processors() const
 {
@@ -74,7 +101,7 @@ ArchGraphCluster::num_subsystems() const
 
 PermGroup
 ArchGraphCluster::automorphisms_(AutomorphismOptions const *options,
-                                 timeout::flag aborted)
+                                 timeout::flag aborted) const
 {
   assert(!_subsystems.empty());
 
@@ -91,7 +118,7 @@ TaskMapping
 ArchGraphCluster::repr_(TaskMapping const &mapping_,
                         ReprOptions const *options_,
                         TMORs *,
-                        timeout::flag aborted)
+                        timeout::flag aborted) const
 {
   auto options(ReprOptions::fill_defaults(options_));
 
@@ -9,6 +9,7 @@ extern "C" {
 }
 
 #include "arch_graph.hpp"
+#include "bsgs.hpp"
 #include "nauty_graph.hpp"
 #include "perm_group.hpp"
 
@@ -74,15 +75,26 @@ std::string ArchGraph::to_gap_nauty() const
   return g.to_gap();
 }
 
-PermSet ArchGraph::automorphism_generators_nauty()
+PermSet ArchGraph::automorphism_generators_nauty() const
 {
   auto g(graph_nauty());
 
   return g.automorphism_generators();
 }
 
+BSGS::order_type ArchGraph::num_automorphisms_nauty() const
+{
+  auto g(graph_nauty());
+
+  BSGS::order_type res = 1;
+  for (unsigned orbit_length : g.automorphism_orbit_lengths())
+    res *= orbit_length;
+
+  return res;
+}
+
 PermGroup ArchGraph::automorphisms_nauty(AutomorphismOptions const *options,
-                                         timeout::flag aborted)
+                                         timeout::flag aborted) const
 {
   auto generators(automorphism_generators_nauty());
 
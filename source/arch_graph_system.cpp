@@ -2,6 +2,7 @@
 #include <atomic>
 #include <cmath>
 #include <functional>
+#include <future>
 #include <limits>
 #include <memory>
 #include <new>
@@ -9,6 +10,7 @@
 #include <queue>
 #include <random>
 #include <stdexcept>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -20,9 +22,11 @@
 #include "arch_graph_system.hpp"
 #include "arch_uniform_super_graph.hpp"
 #include "bsgs.hpp"
+#include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
+#include "schreier_tree.hpp"
 #include "task_mapping.hpp"
 #include "task_mapping_orbit.hpp"
 #include "timeout.hpp"
@@ -73,37 +77,178 @@ std::shared_ptr<ArchGraphSystem> ArchGraphSystem::expand_automorphisms() const
 TMO ArchGraphSystem::automorphisms_orbit(
   TaskMapping const &mapping,
   AutomorphismOptions const *options,
-  timeout::flag aborted)
+  timeout::flag aborted) const
 {
-  automorphisms(options, aborted);
+  init_automorphisms(options, aborted);
 
   return TMO(mapping, _automorphism_generators.with_inverses());
 }
 
-bool ArchGraphSystem::automorphisms_symmetric(ReprOptions const *options)
+std::vector<std::tuple<TaskMapping, bool, unsigned>> ArchGraphSystem::repr_batch(
+  std::vector<TaskMapping> const &mappings,
+  TMORs &orbits,
+  ReprOptions const *options,
+  unsigned num_threads,
+  timeout::flag aborted) const
 {
-  TaskMapping representative;
+  std::vector<std::tuple<TaskMapping, bool, unsigned>> res;
+  res.reserve(mappings.size());
 
-  if (options->optimize_symmetric && !_automorphisms_is_symmetric_valid) {
+  if (options && options->random_engine)
+    num_threads = 1u;
+
+  if (num_threads <= 1u || mappings.size() < 2u * num_threads) {
+    for (auto const &mapping : mappings)
+      res.push_back(repr(mapping, orbits, options, aborted));
+
+    return res;
+  }
+
+  if (!repr_ready_())
+    init_repr(nullptr, aborted);
+
+  // representatives are determined by threads processing contiguous chunks of
+  // mappings, orbits is only read during that time
+  std::vector<TaskMapping> representatives(mappings.size());
+
+  std::size_t chunk_size = (mappings.size() + num_threads - 1u) / num_threads;
+
+  std::vector<std::future<void>> tasks;
+
+  for (unsigned t = 0u; t < num_threads; ++t) {
+    std::size_t first = t * chunk_size;
+    std::size_t last = std::min(first + chunk_size, mappings.size());
+
+    if (first >= last)
+      break;
+
+    tasks.push_back(std::async(std::launch::async, [&, first, last]{
+      for (std::size_t i = first; i < last; ++i)
+        representatives[i] = repr_(mappings[i], options, &orbits, aborted);
+    }));
+  }
+
+  for (auto &task : tasks)
+    task.get();
+
+  for (std::size_t i = 0u; i < mappings.size(); ++i) {
+    auto ins(orbits.insert(representatives[i]));
+
+    res.emplace_back(representatives[i], ins.first, ins.second);
+  }
+
+  return res;
+}
+
+bool ArchGraphSystem::automorphisms_symmetric(ReprOptions const *options) const
+{
+  if (!options->optimize_symmetric)
+    return false;
+
+  _automorphisms_is_symmetric_once.call_once([&]{
     _automorphisms_is_symmetric = _automorphisms.is_symmetric();
 
     if (_automorphisms_is_symmetric) {
       _automorphisms_smp = _automorphism_generators.smallest_moved_point();
       _automorphisms_lmp = _automorphism_generators.largest_moved_point();
     }
+  });
+
+  return _automorphisms_is_symmetric;
+}
+
+std::vector<bool> ArchGraphSystem::automorphisms_moved() const
+{
+  unsigned degree = _automorphisms.degree();
+
+  std::vector<bool> moved(degree, false);
+  for (Perm const &gen : _automorphism_generators) {
+    for (unsigned x = 0u; x < degree; ++x) {
+      if (gen[x] != x)
+        moved[x] = true;
+    }
+  }
+
+  return moved;
+}
+
+bool ArchGraphSystem::automorphisms_decomposable(
+  ReprOptions const *options,
+  std::vector<std::shared_ptr<ArchGraphSystem>> const **factors) const
+{
+  using Decomposition = ReprOptions::Decomposition;
+
+  if (options->decomposition == Decomposition::NONE)
+    return false;
+
+  if (options->decomposition == Decomposition::DISJOINT ||
+      options->decomposition == Decomposition::AUTO) {
+    *factors = &automorphisms_decomposition(Decomposition::DISJOINT);
+
+    if (!(*factors)->empty())
+      return true;
+  }
+
+  if (options->decomposition == Decomposition::WREATH ||
+      options->decomposition == Decomposition::AUTO) {
+    *factors = &automorphisms_decomposition(Decomposition::WREATH);
+
+    if (!(*factors)->empty())
+      return true;
+  }
+
+  return false;
+}
+
+std::vector<std::shared_ptr<ArchGraphSystem>> const &
+ArchGraphSystem::automorphisms_decomposition(
+  ReprOptions::Decomposition decomposition) const
+{
+  // both decompositions are cached separately since concurrent callers might
+  // request different ones
+  auto decompose = [&](std::vector<std::shared_ptr<ArchGraphSystem>> &repr_factors)
+  {
+    std::vector<PermGroup> factors;
+
+    if (decomposition == ReprOptions::Decomposition::DISJOINT) {
+      factors = _automorphisms.disjoint_decomposition();
+
+    } else {
+      factors = _automorphisms.wreath_decomposition();
+
+      // the block permuter comes first in a wreath decomposition but has to be
+      // applied after the block stabilizers
+      if (!factors.empty())
+        std::rotate(factors.begin(), factors.begin() + 1, factors.end());
+    }
+
+    repr_factors.clear();
+
+    if (factors.size() > 1u) {
+      for (auto const &factor : factors)
+        repr_factors.push_back(std::make_shared<ArchGraphAutomorphisms>(factor));
+    }
+  };
+
+  if (decomposition == ReprOptions::Decomposition::DISJOINT) {
+    _repr_factors_disjoint_once.call_once(
+      [&]{ decompose(_repr_factors_disjoint); });
 
-    _automorphisms_is_symmetric_valid = true;
+    return _repr_factors_disjoint;
   }
 
-  return options->optimize_symmetric && _automorphisms_is_symmetric;
+  _repr_factors_wreath_once.call_once(
+    [&]{ decompose(_repr_factors_wreath); });
+
+  return _repr_factors_wreath;
 }
 
 TaskMapping ArchGraphSystem::repr_(TaskMapping const &mapping,
                                    ReprOptions const *options_,
                                    TMORs *orbits,
-                                   timeout::flag aborted)
+                                   timeout::flag aborted) const
 {
-  automorphisms();
+  init_automorphisms(nullptr, aborted);
 
   auto options(ReprOptions::fill_defaults(options_));
 
@@ -113,10 +258,16 @@ TaskMapping ArchGraphSystem::repr_(TaskMapping const &mapping,
   if (automorphisms_symmetric(&options))
     return min_elem_symmetric(mapping, &options);
 
+  std::vector<std::shared_ptr<ArchGraphSystem>> const *factors;
+  if (automorphisms_decomposable(&options, &factors))
+    return min_elem_decomposed(mapping, &options, *factors, aborted);
+
   return options.method == ReprOptions::Method::ITERATE ?
            min_elem_iterate(mapping, &options, orbits, aborted) :
          options.method == ReprOptions::Method::ORBITS ?
            min_elem_orbits(mapping, &options, orbits, aborted) :
+         options.method == ReprOptions::Method::CANONICAL ?
+           min_elem_canonical(mapping, &options, aborted) :
          options.method == ReprOptions::Method::LOCAL_SEARCH ?
            options.variant == ReprOptions::Variant::LOCAL_SEARCH_SA_LINEAR ?
              min_elem_local_search_sa(mapping, &options) :
@@ -129,19 +280,62 @@ TaskMapping ArchGraphSystem::min_elem_iterate(TaskMapping const &tasks,
                                               TMORs *orbits,
                                               timeout::flag aborted) const
 {
+  unsigned degree = _automorphisms.degree();
+
+  auto moved(automorphisms_moved());
+
+  // iterate over the automorphisms using a BSGS whose base starts with the
+  // (moved) processors in the order in which they first occur in tasks, the
+  // image of the i-th base point then only depends on the transversals of the
+  // first i stabilizer chain levels, so whenever an automorphism maps tasks
+  // to something larger than the current representative, all remaining
+  // automorphisms agreeing with it up to the level of the base point at the
+  // first differing position can be skipped
+  std::vector<unsigned> prefix;
+  std::vector<unsigned> prefix_level(degree, degree);
+
+  for (unsigned task : tasks) {
+    if (task < options->offset || task >= options->offset + degree)
+      continue;
+
+    unsigned pe = task - options->offset;
+    if (!moved[pe] || prefix_level[pe] < degree)
+      continue;
+
+    prefix_level[pe] = prefix.size();
+    prefix.push_back(pe);
+  }
+
   TaskMapping representative(tasks);
 
-  for (auto it = _automorphisms.begin(); it != _automorphisms.end(); ++it) {
+  if (prefix.empty())
+    return representative;
+
+  PermGroup::const_iterator it(*_automorphisms.bsgs(prefix));
+  PermGroup::const_iterator end;
+
+  while (it != end) {
     if (timeout::is_set(aborted))
       throw timeout::AbortedError("min_elem_iterate");
 
     auto const &factors(it.factors());
 
-    if (tasks.less_than(representative, factors, options->offset))
-      representative = tasks.permuted(factors, options->offset);
+    unsigned pos;
+    int cmp = tasks.compare(representative, factors, options->offset, &pos);
+
+    if (cmp < 0) {
+      tasks.permuted_into(representative, factors, options->offset);
+
+      if (is_repr(representative, options, orbits))
+        return representative;
+
+      ++it;
 
-    if (is_repr(representative, options, orbits)) {
-      return representative;
+    } else if (cmp > 0) {
+      it.skip(prefix_level[tasks[pos] - options->offset]);
+
+    } else {
+      ++it;
     }
   }
 
@@ -159,6 +353,8 @@ TaskMapping ArchGraphSystem::min_elem_orbits(TaskMapping const &tasks,
 
   unprocessed.insert(tasks);
 
+  TaskMapping next;
+
   while (!unprocessed.empty()) {
     if (timeout::is_set(aborted))
       throw timeout::AbortedError("min_elem_orbits");
@@ -173,7 +369,7 @@ TaskMapping ArchGraphSystem::min_elem_orbits(TaskMapping const &tasks,
       representative = current;
 
     for (Perm const &gen : _automorphism_generators) {
-      TaskMapping next(current.permuted(gen, options->offset));
+      current.permuted_into(next, gen, options->offset);
 
       if (is_repr(next, options, orbits))
         return next;
@@ -185,6 +381,61 @@ TaskMapping ArchGraphSystem::min_elem_orbits(TaskMapping const &tasks,
   return representative;
 }
 
+TaskMapping ArchGraphSystem::min_elem_canonical(TaskMapping const &tasks,
+                                                ReprOptions const *options,
+                                                timeout::flag aborted) const
+{
+  unsigned degree = _automorphisms.degree();
+
+  auto moved(automorphisms_moved());
+
+  // processors are considered in the order in which they first occur in the
+  // representative, after every step the images of all processors considered
+  // so far are minimal and fixed, the remaining degree of freedom is the
+  // pointwise stabilizer of these images, so the next processor is mapped onto
+  // the smallest element of its orbit under that stabilizer, since the fixed
+  // images are always orbit minima, only few distinct base prefixes occur and
+  // the base changed BSGSs cached by the automorphism group are reused often
+  TaskMapping representative(tasks);
+
+  std::vector<unsigned> prefix;
+  std::vector<bool> in_prefix(degree, false);
+
+  for (unsigned i = 0u; i < representative.size(); ++i) {
+    if (timeout::is_set(aborted))
+      throw timeout::AbortedError("min_elem_canonical");
+
+    unsigned task = representative[i];
+    if (task < options->offset || task >= options->offset + degree)
+      continue;
+
+    unsigned pe = task - options->offset;
+    if (!moved[pe] || in_prefix[pe])
+      continue;
+
+    auto bsgs(_automorphisms.bsgs(prefix));
+
+    // the stabilizer of the processors considered so far is trivial
+    if (prefix.size() >= bsgs->base_size())
+      break;
+
+    auto stabilizers(bsgs->strong_generators(prefix.size()).with_inverses());
+
+    auto ss(std::make_shared<SchreierTree>(degree, pe, stabilizers));
+    auto orbit(Orbit::generate(pe, stabilizers, ss));
+
+    unsigned pe_min = *std::min_element(orbit.begin(), orbit.end());
+
+    if (pe_min != pe)
+      representative.permute(ss->transversal(pe_min), options->offset);
+
+    prefix.push_back(pe_min);
+    in_prefix[pe_min] = true;
+  }
+
+  return representative;
+}
+
 TaskMapping ArchGraphSystem::min_elem_local_search(
   TaskMapping const &tasks,
   ReprOptions const *options) const
@@ -193,8 +444,13 @@ TaskMapping ArchGraphSystem::min_elem_local_search(
 
   TaskMapping representative(tasks);
 
+  // buffers are reused between iterations, only the first
+  // num_possible_representatives of them are valid in each iteration
   std::vector<TaskMapping> possible_representatives;
-  possible_representatives.reserve(generators.size());
+  unsigned num_possible_representatives = 0u;
+
+  if (options->variant == ReprOptions::Variant::LOCAL_SEARCH_BFS)
+    possible_representatives.resize(generators.size());
 
   for (;;) {
     bool stationary = true;
@@ -202,8 +458,10 @@ TaskMapping ArchGraphSystem::min_elem_local_search(
     for (Perm const &gen : generators) {
       if (representative.less_than(representative, gen, options->offset)) {
         if (options->variant == ReprOptions::Variant::LOCAL_SEARCH_BFS) {
-          possible_representatives.push_back(
-            representative.permuted(gen, options->offset));
+          representative.permuted_into(
+            possible_representatives[num_possible_representatives++],
+            gen,
+            options->offset);
         } else {
           representative.permute(gen, options->offset);
         }
@@ -217,12 +475,13 @@ TaskMapping ArchGraphSystem::min_elem_local_search(
 
     if (options->variant == ReprOptions::Variant::LOCAL_SEARCH_BFS) {
       representative = *std::min_element(possible_representatives.begin(),
-                                         possible_representatives.end(),
+                                         possible_representatives.begin() +
+                                         num_possible_representatives,
                                          [](TaskMapping const &lhs,
                                             TaskMapping const &rhs)
                                          { return lhs.less_than(rhs); });
 
-      possible_representatives.clear();
+      num_possible_representatives = 0u;
     }
   }
 
@@ -236,7 +495,7 @@ PermSet ArchGraphSystem::local_search_augment_gens(
 
   // append random generators
   for (unsigned i = 0u; i < options->local_search_append_generators; ++i)
-    generators.insert(_automorphisms.random_element());
+    generators.insert(_automorphisms.random_element(options->random_engine));
 
   return generators;
 }
@@ -248,7 +507,7 @@ TaskMapping ArchGraphSystem::min_elem_local_search_sa(
   using namespace std::placeholders;
 
   // probability distributions
-  static auto re(util::random_engine());
+  auto &re(util::random_engine_or_default(options->random_engine));
 
   std::uniform_real_distribution<> d_prob(0.0, 1.0);
 
@@ -264,22 +523,29 @@ TaskMapping ArchGraphSystem::min_elem_local_search_sa(
   std::vector<unsigned> gen_indices(_automorphism_generators.size());
   std::iota(gen_indices.begin(), gen_indices.end(), 0u);
 
+  std::vector<unsigned> gen_queue;
+
+  TaskMapping next;
+
   for (unsigned i = 0u; i < options->local_search_sa_iterations; ++i) {
     // schedule T
     double T = local_search_sa_schedule_T(i, options);
 
     // generate random possible representative
-    TaskMapping next;
+    next.clear();
 
-    auto gen_queue(gen_indices);
+    gen_queue.assign(gen_indices.begin(), gen_indices.end());
     std::shuffle(gen_queue.begin(), gen_queue.end(), re);
 
     while (!gen_queue.empty()) {
-      Perm random_gen(_automorphism_generators[gen_queue.back()]);
+      Perm const &random_gen(_automorphism_generators[gen_queue.back()]);
       gen_queue.pop_back();
 
       bool next_valid = false;
-      next = representative.permuted(random_gen, options->offset, &next_valid);
+      representative.permuted_into(next,
+                                   random_gen,
+                                   options->offset,
+                                   &next_valid);
 
       if (next_valid) {
         break;
@@ -367,4 +633,21 @@ TaskMapping ArchGraphSystem::min_elem_symmetric(
   return representative;
 }
 
+TaskMapping ArchGraphSystem::min_elem_decomposed(
+  TaskMapping const &tasks,
+  ReprOptions const *options,
+  std::vector<std::shared_ptr<ArchGraphSystem>> const &factors,
+  timeout::flag aborted) const
+{
+  ReprOptions factor_options(*options);
+  factor_options.decomposition = ReprOptions::Decomposition::NONE;
+
+  TaskMapping representative(tasks);
+
+  for (auto const &factor : factors)
+    representative = factor->repr(representative, &factor_options, aborted);
+
+  return representative;
+}
+
 } // namespace mpsym
@@ -140,7 +140,7 @@ ArchUniformSuperGraph::wreath_product_action_proto(
 
 PermGroup
 ArchUniformSuperGraph::automorphisms_(AutomorphismOptions const *options,
-                                      timeout::flag aborted)
+                                      timeout::flag aborted) const
 {
   return PermGroup::wreath_product(
     _subsystem_proto->automorphisms(options, aborted),
@@ -151,25 +151,25 @@ ArchUniformSuperGraph::automorphisms_(AutomorphismOptions const *options,
 
 void
 ArchUniformSuperGraph::init_repr_(AutomorphismOptions const *options,
-                                  timeout::flag aborted)
+                                  timeout::flag aborted) const
 {
-  auto automs_super_graph(
-    _subsystem_super_graph->automorphisms(options, aborted));
+  _sigmas_once.call_once([&]{
+    auto automs_super_graph(
+      _subsystem_super_graph->automorphisms(options, aborted));
 
-  auto automs_proto(
-    _subsystem_proto->automorphisms(options, aborted));
+    auto automs_proto(
+      _subsystem_proto->automorphisms(options, aborted));
 
-  _super_graph_trivial = automs_super_graph.is_trivial();
-  _proto_trivial = automs_proto.is_trivial();
+    _super_graph_trivial = automs_super_graph.is_trivial();
+    _proto_trivial = automs_proto.is_trivial();
 
-  if (_super_graph_trivial || _proto_trivial) {
-    _sigma_total = std::make_shared<ArchGraphAutomorphisms>(automorphisms(options, aborted));
-  } else {
-    _sigma_super_graph = wreath_product_action_super_graph(options, aborted);
-    _sigmas_proto = wreath_product_action_proto(options, aborted);
-  }
-
-  _sigmas_valid = true;
+    if (_super_graph_trivial || _proto_trivial) {
+      _sigma_total = std::make_shared<ArchGraphAutomorphisms>(automorphisms(options, aborted));
+    } else {
+      _sigma_super_graph = wreath_product_action_super_graph(options, aborted);
+      _sigmas_proto = wreath_product_action_proto(options, aborted);
+    }
+  });
 }
 
 bool
@@ -177,7 +177,7 @@ ArchUniformSuperGraph::repr_ready_() const
 {
   return _subsystem_super_graph->automorphisms_ready() &&
          _subsystem_proto->automorphisms_ready() &&
-         _sigmas_valid;
+         _sigmas_once.done();
 }
 
 void
@@ -185,21 +185,21 @@ ArchUniformSuperGraph::reset_repr_()
 {
   _subsystem_super_graph->reset_automorphisms();
   _subsystem_proto->reset_automorphisms();
-  _sigmas_valid = false;
+  _sigmas_once.reset();
 }
 
 TaskMapping
 ArchUniformSuperGraph::repr_(TaskMapping const &mapping,
                              ReprOptions const *options,
                              TMORs *,
-                             timeout::flag aborted)
+                             timeout::flag aborted) const
 {
   TaskMapping representative(mapping);
 
   if (_super_graph_trivial || _proto_trivial)
     return _sigma_total->repr(representative, options, aborted);
 
-  for (auto &sigma : _sigmas_proto)
+  for (auto const &sigma : _sigmas_proto)
     representative = sigma->repr(representative, options, aborted);
 
   return _sigma_super_graph->repr(representative, options, aborted);
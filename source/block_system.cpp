@@ -372,6 +372,12 @@ void BlockSystem::minimal_compress_classpath(std::vector<unsigned> &classpath)
 std::vector<BlockSystem> BlockSystem::non_trivial_transitive(
   PermGroup const &pg)
 {
+  // trivial group acting on a single point
+  if (pg.bsgs().base_empty()) {
+    DBG(TRACE) << "Group is trivial";
+    return {};
+  }
+
   // first base element
   unsigned first_base_elem = pg.bsgs().base_point(0);
   DBG(TRACE) << "First base element is: " << first_base_elem;
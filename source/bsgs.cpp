@@ -7,6 +7,8 @@
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -39,14 +41,47 @@ void BSGSTransversalsBase::reserve_schreier_structure(
 }
 
 void BSGSTransversalsBase::update_schreier_structure(
-  unsigned i, unsigned root, unsigned degree, PermSet const &generators)
+  unsigned i, unsigned root, unsigned degree, PermSet const &generators,
+  PermSet const &generators_fixing_orbit)
+{
+  if (generators_fixing_orbit.empty()) {
+    update_schreier_structure(i, root, degree, generators, nullptr, 0u);
+    return;
+  }
+
+  update_schreier_structure(
+    i, root, degree, generators,
+    std::make_shared<PermSet const>(generators_fixing_orbit),
+    generators_fixing_orbit.size());
+}
+
+void BSGSTransversalsBase::update_schreier_structure(
+  unsigned i, unsigned root, unsigned degree, PermSet const &generators,
+  std::shared_ptr<PermSet const> const &generators_fixing_orbit,
+  unsigned num_generators_fixing_orbit)
 {
   auto ss(make_schreier_structure(root, degree, generators));
 
+  // generators that fix the orbit of root pointwise are only stored as labels,
+  // levels are rebuilt from all their labels during base changes so these
+  // must be closed under inversion just like the orbit generators
+  if (num_generators_fixing_orbit > 0u) {
+#ifndef NDEBUG
+    PermSet(generators_fixing_orbit->begin(),
+            generators_fixing_orbit->begin() + num_generators_fixing_orbit)
+      .assert_inverses();
+#endif
+
+    ss->share_labels_fixing_orbit(generators_fixing_orbit,
+                                  num_generators_fixing_orbit);
+  }
+
   Orbit::generate(root, generators, ss);
 
-  if (i < _schreier_structures.size())
+  if (i < _schreier_structures.size()) {
     _schreier_structures[i].swap(ss);
+    return;
+  }
 
   assert(i == _schreier_structures.size());
 
@@ -92,7 +127,7 @@ BSGS::BSGS(unsigned degree,
     generators_minimized.minimize_degree();
 
     if (generators_minimized.degree() > 8u) {
-      PrRandomizer pr(generators_minimized);
+      PrRandomizer pr(generators_minimized, options.random_engine);
 
       if (pr.test_symmetric())
         construct_sym = true;
@@ -142,12 +177,87 @@ BSGS::BSGS(unsigned degree,
   assert(sgs.empty());
 }
 
+BSGS BSGS::symmetric(unsigned degree, BSGSOptions const *options_)
+{
+  BSGS bsgs(degree);
+
+  if (degree == 1u)
+    return bsgs;
+
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  bsgs.transversals_init(&options);
+
+  std::vector<unsigned> support(degree);
+  std::iota(support.begin(), support.end(), 0u);
+
+  bsgs.construct_symmetric(support);
+
+  return bsgs;
+}
+
+BSGS BSGS::alternating(unsigned degree, BSGSOptions const *options_)
+{
+  BSGS bsgs(degree);
+
+  if (degree < 3u)
+    return bsgs;
+
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  bsgs.transversals_init(&options);
+
+  std::vector<unsigned> support(degree);
+  std::iota(support.begin(), support.end(), 0u);
+
+  bsgs.construct_alternating(support);
+
+  return bsgs;
+}
+
+BSGS BSGS::cyclic(unsigned degree, BSGSOptions const *options)
+{
+  if (degree == 1u)
+    return BSGS(degree);
+
+  std::vector<unsigned> rotation(degree);
+  for (unsigned i = 0u; i < degree; ++i)
+    rotation[i] = (i + 1u) % degree;
+
+  PermSet strong_generators {Perm(rotation)};
+  strong_generators.insert_inverses();
+
+  return BSGS(degree, {0u}, strong_generators, options);
+}
+
+BSGS BSGS::dihedral(unsigned degree, BSGSOptions const *options)
+{
+  if (degree < 3u)
+    return BSGS::symmetric(degree, options);
+
+  // the rotation acts regularly on all points and the reflection generates the
+  // point stabilizer of 0 which has orbit {1, degree - 1}
+  std::vector<unsigned> rotation(degree);
+  std::vector<unsigned> reflection(degree);
+
+  for (unsigned i = 0u; i < degree; ++i) {
+    rotation[i] = (i + 1u) % degree;
+    reflection[i] = (degree - i) % degree;
+  }
+
+  PermSet strong_generators {Perm(rotation), Perm(reflection)};
+  strong_generators.insert_inverses();
+
+  return BSGS(degree, {0u, 1u}, strong_generators, options);
+}
+
 BSGS::order_type BSGS::order() const
 {
   order_type res = 1;
 
+  // only the orbit lengths are needed, so avoid materializing the orbits
   for (unsigned i = 0u; i < base_size(); ++i)
-    res *= orbit(i).size();
+    res *= schreier_structure(i)->size();
 
   return res;
 }
@@ -202,9 +312,159 @@ std::pair<Perm, unsigned> BSGS::strip(Perm const &perm, unsigned offs) const
 
 bool BSGS::strips_completely(Perm const &perm) const
 {
-  auto strip_result(strip(perm));
+  assert(perm.degree() == degree());
+
+  // only keep track of the images of the base points under the residue and
+  // fail as soon as one of them does not lie in the corresponding orbit
+  std::vector<unsigned> base_images(base_size());
+  for (unsigned i = 0u; i < base_size(); ++i)
+    base_images[i] = perm[base_point(i)];
+
+  std::vector<Perm> transversals_inv;
+  transversals_inv.reserve(base_size());
+
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    auto ss(schreier_structure(i));
+
+    unsigned beta = base_images[i];
+    if (!ss->contains(beta))
+      return false;
+
+    transversals_inv.push_back(~ss->transversal(beta));
 
-  return strip_result.first.id() && strip_result.second == base_size() + 1u;
+    Perm const &transversal_inv = transversals_inv.back();
+    for (unsigned j = i + 1u; j < base_size(); ++j)
+      base_images[j] = transversal_inv[base_images[j]];
+  }
+
+  // the residue fixes all base points, check whether it is the identity
+  // without explicitly constructing it
+  for (unsigned x = 0u; x < degree(); ++x) {
+    unsigned y = perm[x];
+    for (Perm const &transversal_inv : transversals_inv)
+      y = transversal_inv[y];
+
+    if (y != x)
+      return false;
+  }
+
+  return true;
+}
+
+std::vector<bool> BSGS::strips_completely(std::vector<Perm> const &perms,
+                                          unsigned num_threads) const
+{
+  std::vector<bool> res(perms.size(), false);
+
+  if (num_threads <= 1u || perms.size() < 2u * num_threads) {
+    strips_completely_range(perms, 0u, perms.size(), res);
+    return res;
+  }
+
+  // every thread strips a contiguous chunk of permutations, the results are
+  // merged afterwards since std::vector<bool> can't be written concurrently
+  std::size_t chunk_size = (perms.size() + num_threads - 1u) / num_threads;
+
+  std::vector<std::vector<bool>> res_chunks(num_threads);
+  std::vector<std::thread> threads;
+
+  for (unsigned t = 0u; t < num_threads; ++t) {
+    std::size_t first = t * chunk_size;
+    std::size_t last = std::min(first + chunk_size, perms.size());
+
+    if (first >= last)
+      break;
+
+    res_chunks[t].resize(last - first);
+
+    threads.emplace_back([&, t, first, last]{
+      strips_completely_range(perms, first, last, res_chunks[t]);
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (unsigned t = 0u; t < threads.size(); ++t)
+    std::copy(res_chunks[t].begin(), res_chunks[t].end(),
+              res.begin() + t * chunk_size);
+
+  return res;
+}
+
+void BSGS::strips_completely_range(std::vector<Perm> const &perms,
+                                   std::size_t first,
+                                   std::size_t last,
+                                   std::vector<bool> &res) const
+{
+  std::size_t n = last - first;
+  unsigned k = base_size();
+
+  // sift all permutations level by level, at every level each inverse
+  // transversal is constructed at most once
+  std::vector<unsigned> base_images(n * k);
+  std::vector<Perm const *> transversals_inv(n * k);
+
+  std::vector<std::size_t> remaining(n);
+
+  for (std::size_t p = 0u; p < n; ++p) {
+    Perm const &perm = perms[first + p];
+
+    assert(perm.degree() == degree());
+
+    for (unsigned i = 0u; i < k; ++i)
+      base_images[p * k + i] = perm[base_point(i)];
+
+    remaining[p] = p;
+  }
+
+  std::vector<std::unordered_map<unsigned, Perm>> transversals_inv_cache(k);
+
+  for (unsigned i = 0u; i < k; ++i) {
+    auto ss(schreier_structure(i));
+    auto &cache(transversals_inv_cache[i]);
+
+    std::vector<std::size_t> remaining_next;
+    remaining_next.reserve(remaining.size());
+
+    for (std::size_t p : remaining) {
+      unsigned beta = base_images[p * k + i];
+      if (!ss->contains(beta))
+        continue;
+
+      auto it(cache.find(beta));
+      if (it == cache.end())
+        it = cache.emplace(beta, ~ss->transversal(beta)).first;
+
+      Perm const &transversal_inv = it->second;
+      transversals_inv[p * k + i] = &transversal_inv;
+
+      for (unsigned j = i + 1u; j < k; ++j)
+        base_images[p * k + j] = transversal_inv[base_images[p * k + j]];
+
+      remaining_next.push_back(p);
+    }
+
+    remaining.swap(remaining_next);
+  }
+
+  for (std::size_t p : remaining) {
+    Perm const &perm = perms[first + p];
+
+    bool id = true;
+    for (unsigned x = 0u; x < degree(); ++x) {
+      unsigned y = perm[x];
+      for (unsigned i = 0u; i < k; ++i)
+        y = (*transversals_inv[p * k + i])[y];
+
+      if (y != x) {
+        id = false;
+        break;
+      }
+    }
+
+    res[p] = id;
+  }
 }
 
 void BSGS::extend_base(unsigned bp)
@@ -251,6 +511,33 @@ void BSGS::construct_symmetric(std::vector<unsigned> const &support)
   _is_symmetric = true;
 }
 
+void BSGS::construct_alternating(std::vector<unsigned> const &support)
+{
+  DBG(DEBUG) << "Group is alternating";
+
+  if (support.size() < 3u)
+    return;
+
+  // the alternating group on a set X is generated by all 3-cycles (x, a, b)
+  // for two fixed a, b in X and all other x in X
+  unsigned a = support[support.size() - 2u];
+  unsigned b = support.back();
+
+  _base = std::vector<unsigned>(support.begin(), support.end() - 2);
+
+  for (auto it(_base.rbegin()); it != _base.rend(); ++it)
+    _strong_generators.insert(Perm(_degree, {{*it, a, b}}));
+
+  for (unsigned i = 0u; i < _base.size(); ++i) {
+    PermSet tmp(_strong_generators.subset(0, support.size() - i - 2u));
+    tmp.insert_inverses();
+
+    update_schreier_structure(i, tmp);
+  }
+
+  _is_alternating = true;
+}
+
 void BSGS::construct_unknown(PermSet const &generators,
                              BSGSOptions const *options,
                              timeout::flag aborted)
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -9,6 +10,7 @@
 #include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_set.hpp"
+#include "random.hpp"
 #include "schreier_generator_queue.hpp"
 #include "schreier_structure.hpp"
 
@@ -18,10 +20,13 @@ namespace mpsym
 namespace internal
 {
 
-void BSGS::base_change(std::vector<unsigned> prefix)
+void BSGS::base_change(std::vector<unsigned> prefix,
+                       BSGSOptions const *options_)
 {
   DBG(DEBUG) << "Appending prefix " << prefix << " to base " << _base;
 
+  auto options(BSGSOptions::fill_defaults(options_));
+
   Perm conj(degree());
   Perm conj_inv(degree());
 
@@ -62,7 +67,7 @@ void BSGS::base_change(std::vector<unsigned> prefix)
       unsigned j = insert_redundant_base_point(target, i);
       DBG(TRACE) << "Inserted " << target << " into base: " << _base;
 
-      transpose_base_point(j, i);
+      transpose_base_point(j, i, &options);
       DBG(TRACE) << "Base after transposition: " << _base;
     }
   }
@@ -76,7 +81,30 @@ void BSGS::base_change(std::vector<unsigned> prefix)
   assert(std::equal(prefix.begin(), prefix.end(), _base.begin()));
 }
 
-void BSGS::swap_base_points(unsigned i)
+BSGS BSGS::with_base_prefix(std::vector<unsigned> const &prefix,
+                            BSGSOptions const *options) const
+{
+  BSGS res(*this);
+
+  if (base_empty() || has_base_prefix(prefix))
+    return res;
+
+  // base changes replace schreier structures instead of modifying them
+  res._transversals = _transversals->clone();
+  res.base_change(prefix, options);
+
+  return res;
+}
+
+bool BSGS::has_base_prefix(std::vector<unsigned> const &prefix) const
+{
+  if (prefix.size() > base_size())
+    return false;
+
+  return std::equal(prefix.begin(), prefix.end(), _base.begin());
+}
+
+void BSGS::swap_base_points(unsigned i, BSGSOptions const *options)
 {
   DBG(TRACE) << "Swapping base points " << i + 1u << " and " << i + 2u;
 
@@ -87,13 +115,17 @@ void BSGS::swap_base_points(unsigned i)
   std::swap(_base[i], _base[i + 1u]);
   DBG(TRACE) << "New base: " << _base;
 
-  // recompute schreier structures for base points i and i+1
+  // recompute schreier structures for base points i and i+1, the previous ones
+  // are kept around to draw random elements of the stabilizer at level i
+  auto ssi(schreier_structure(i));
+  auto ssi1(schreier_structure(i + 1u));
+
   auto sgi(stabilizers(i));
   auto oi(orbit(i));
 
   update_schreier_structure(i, sgi);
 
-  auto sgi1(strong_generators(i + 1u));
+  auto sgi1(strong_generators(i + 1u).with_inverses());
   auto oi1(orbit(i + 1u));
 
   update_schreier_structure(i + 1u, sgi1);
@@ -103,28 +135,65 @@ void BSGS::swap_base_points(unsigned i)
 
   DBG(TRACE) << "Desired size of O(" << i + 1u << ") is " << oi1_desired_size;
 
-  // iterate over schreier generators
-  SchreierGeneratorQueue schreier_generator_queue;
+  auto extend_sgi1 = [&](Perm const &perm){
+    if (schreier_structure(i + 1u)->contains(perm[base_point(i + 1u)]))
+      return false;
+
+    DBG(TRACE) << "Updating strong generators:";
+
+    // extend strong generators
+    sgi1.insert(perm);
+    sgi1.insert_inverses();
+    update_schreier_structure(i + 1u, sgi1);
+
+    DBG(TRACE) << "S(" << i + 1u << ") = " << stabilizers(i + 1u);
+    DBG(TRACE) << "O(" << i + 1u << ") = " << orbit(i + 1u);
+
+    return orbit(i + 1u).size() >= oi1_desired_size;
+  };
 
-  sgi = stabilizers(i);
-  oi = orbit(i);
+  if (orbit(i + 1u).size() >= oi1_desired_size) {
+    DBG(TRACE) << "Strong generators already suffice";
 
-  schreier_generator_queue.update(sgi, oi, schreier_structure(i));
+  } else if (options->base_change_randomized) {
+    // every element of the stabilizer at level i is a product of transversals
+    // of the previous levels i+1 and i (modulo the stabilizer at level i+2
+    // which is already contained in S(i+1)), multiplying such an element with
+    // the inverse of the matching transversal of the new level i yields a
+    // random element of the new stabilizer at level i+1
+    auto &re(util::random_engine_or_default(options->random_engine));
 
-  for (Perm const &perm : schreier_generator_queue) {
-    DBG(TRACE) << "Schreier Generator: " << perm;
+    std::uniform_int_distribution<decltype(oi.size())> oi_dist(
+      0u, oi.size() - 1u);
+    std::uniform_int_distribution<decltype(oi1.size())> oi1_dist(
+      0u, oi1.size() - 1u);
 
-    if (!schreier_structure(i + 1)->contains(perm[base_point(i + 1u)])) {
-      DBG(TRACE) << "Updating strong generators:";
+    for (;;) {
+      Perm u(ssi->transversal(*(oi.begin() + oi_dist(re))));
+      Perm u1(ssi1->transversal(*(oi1.begin() + oi1_dist(re))));
 
-      // extend strong generators
-      sgi1.insert(perm);
-      update_schreier_structure(i + 1u, sgi1);
+      Perm perm(u1 * u);
+      perm *= ~schreier_structure(i)->transversal(perm[base_point(i)]);
 
-      DBG(TRACE) << "S(" << i + 1u << ") = " << stabilizers(i + 1u);
-      DBG(TRACE) << "O(" << i + 1u << ") = " << orbit(i + 1u);
+      DBG(TRACE) << "Random stabilizer element: " << perm;
 
-      if (orbit(i + 1u).size() >= oi1_desired_size)
+      if (extend_sgi1(perm))
+        break;
+    }
+
+  } else {
+    // iterate over schreier generators
+    SchreierGeneratorQueue schreier_generator_queue;
+
+    sgi = stabilizers(i);
+    oi = orbit(i);
+
+    schreier_generator_queue.update(sgi, oi, schreier_structure(i));
+
+    for (Perm const &perm : schreier_generator_queue) {
+      DBG(TRACE) << "Schreier Generator: " << perm;
+
+      if (extend_sgi1(perm))
         break;
     }
   }
@@ -138,11 +207,13 @@ void BSGS::swap_base_points(unsigned i)
   _strong_generators.make_unique();
 }
 
-void BSGS::transpose_base_point(unsigned i, unsigned j)
+void BSGS::transpose_base_point(unsigned i,
+                                unsigned j,
+                                BSGSOptions const *options)
 {
    // swap base points until the base point at position i has moved to position j
    while (i > j) {
-     swap_base_points(i - 1u);
+     swap_base_points(i - 1u, options);
      --i;
    }
 }
@@ -184,17 +255,36 @@ unsigned BSGS::insert_redundant_base_point(unsigned bp, unsigned i_min)
 
 void BSGS::conjugate(Perm const &conj)
 {
+  if (conj.id())
+    return;
+
+  Perm conj_inv(~conj);
+
   // conjugate base
   for (unsigned &b : _base)
     b = conj[b];
 
   // conjugate strong generating set
   for (Perm &sg : _strong_generators)
-    sg = ~conj * sg * conj;
+    sg = conj_inv * sg * conj;
+
+  // update schreier structures, levels whose base point and stabilizers are
+  // left unchanged by the conjugation are skipped
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    auto ss(schreier_structure(i));
+    auto stabs(ss->labels());
 
-  // update schreier structures
-  for (unsigned i = 0u; i < base_size(); ++i)
-    update_schreier_structure(i, strong_generators(i));
+    PermSet stabs_conj;
+    for (Perm const &stab : stabs)
+      stabs_conj.insert(conj_inv * stab * conj);
+
+    if (ss->root() == base_point(i) &&
+        std::equal(stabs.begin(), stabs.end(), stabs_conj.begin())) {
+      continue;
+    }
+
+    update_schreier_structure(i, stabs_conj);
+  }
 }
 
 } // namespace internal
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+#include <vector>
+
+#include "bsgs.hpp"
+#include "dbg.hpp"
+#include "orbit.hpp"
+#include "perm.hpp"
+#include "perm_set.hpp"
+#include "schreier_structure.hpp"
+#include "timeout.hpp"
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+void BSGS::extend(PermSet const &generators,
+                  BSGSOptions const *options_,
+                  timeout::flag aborted)
+{
+  if (generators.empty())
+    return;
+
+  unsigned extended_degree = generators.degree();
+
+  assert(extended_degree >= degree());
+
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  DBG(DEBUG) << "Extending BSGS";
+  DBG(DEBUG) << "New generators: " << generators;
+
+  // only generators not already contained in the group need to be sifted
+  PermSet new_generators;
+  for (Perm const &gen : generators) {
+    if (gen.id())
+      continue;
+
+    if (extended_degree > degree() || !strips_completely(gen))
+      new_generators.insert(gen);
+  }
+
+  // the group is no longer known to be the symmetric or alternating group on
+  // all points if it acts on additional points or is extended by generators
+  // it does not already contain, this has to happen before any of the early
+  // returns below
+  if (extended_degree > degree() || !new_generators.empty()) {
+    _is_symmetric = false;
+    _is_alternating = false;
+  }
+
+  if (new_generators.empty()) {
+    if (extended_degree == degree())
+      return;
+
+    if (base_empty()) {
+      _degree = extended_degree;
+      return;
+    }
+
+  } else if (base_empty()) {
+    *this = BSGS(extended_degree, new_generators, &options, aborted);
+    return;
+  }
+
+  std::vector<PermSet> strong_generators;
+  std::vector<Orbit> fundamental_orbits;
+
+  extend_init(extended_degree, strong_generators, fundamental_orbits);
+
+  // sift new generators into the existing stabilizer chain
+  int level = -1;
+
+  for (Perm const &gen : new_generators) {
+    level = std::max(
+      level, extend_sift(gen, strong_generators, fundamental_orbits));
+  }
+
+  if (level < 0)
+    return;
+
+  DBG(TRACE) << "Completing levels up to " << level + 1;
+
+  // complete only those levels whose generating sets have changed
+  schreier_sims(strong_generators, fundamental_orbits, &options, aborted, level);
+
+  if (options.reduce_gens)
+    reduce_gens();
+
+  DBG(DEBUG) << "=> B = " << _base;
+  DBG(DEBUG) << "=> SGS = " << _strong_generators;
+}
+
+void BSGS::extend_init(unsigned degree,
+                       std::vector<PermSet> &strong_generators,
+                       std::vector<Orbit> &fundamental_orbits)
+{
+  // the schreier structures might be shared with copies of this BSGS
+  _transversals = _transversals->clone();
+
+  _degree = degree;
+
+  for (Perm &sg : _strong_generators)
+    sg = sg.extended(degree);
+
+  // rebuild schreier structures whose labels are closed under inversion, as
+  // required for updating them incrementally
+  for (unsigned i = 0u; i < base_size(); ++i) {
+    PermSet level_generators;
+    for (Perm const &gen : stabilizers(i))
+      level_generators.insert(gen.extended(degree));
+
+    level_generators.insert_inverses();
+
+    update_schreier_structure(i, level_generators);
+
+    strong_generators.push_back(level_generators);
+    fundamental_orbits.push_back(orbit(i));
+  }
+}
+
+int BSGS::extend_sift(Perm const &generator,
+                      std::vector<PermSet> &strong_generators,
+                      std::vector<Orbit> &fundamental_orbits)
+{
+  Perm strip_perm;
+  unsigned strip_level;
+
+  std::tie(strip_perm, strip_level) = strip(generator);
+
+  DBG(TRACE) << generator << " strips to: " << strip_perm << ", " << strip_level;
+
+  if (strip_level > base_size()) {
+    if (strip_perm.id())
+      return -1;
+
+    // extend base
+    for (unsigned bp = 0u; bp < degree(); ++bp) {
+      if (strip_perm[bp] != bp &&
+          std::find(_base.begin(), _base.end(), bp) == _base.end()) {
+
+        extend_base(bp);
+
+        DBG(TRACE) << "Adjoined new basepoint:";
+        DBG(TRACE) << "B = " << _base;
+
+        break;
+      }
+    }
+
+    strip_level = base_size();
+  }
+
+  // the residue lies in all stabilizers up to the level at which it failed
+  for (unsigned i = 0u; i < strip_level; ++i) {
+    schreier_sims_update_strong_gens(
+      i, {strip_perm}, strong_generators, fundamental_orbits);
+
+    DBG(TRACE) << "S(" << (i + 1u) << ") = " << strong_generators[i];
+    DBG(TRACE) << "O(" << (i + 1u) << ") = " << fundamental_orbits[i];
+  }
+
+  return static_cast<int>(strip_level) - 1;
+}
+
+} // namespace internal
+
+} // namespace mpsym
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "bsgs.hpp"
+#include "dbg.hpp"
+#include "orbit.hpp"
+#include "perm.hpp"
+#include "perm_set.hpp"
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+BSGS BSGS::direct_product(std::vector<BSGS> const &factors,
+                          BSGSOptions const *options_)
+{
+  assert(!factors.empty());
+
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  DBG(DEBUG) << "Constructing direct product BSGS of "
+             << factors.size() << " factors";
+
+  // shift factor strong generators into their respective blocks
+  unsigned degree = 0u;
+  std::vector<unsigned> offsets;
+
+  for (auto const &factor : factors) {
+    offsets.push_back(degree);
+    degree += factor.degree();
+  }
+
+  auto lift = [&](Perm const &perm, unsigned k)
+  { return perm.shifted(offsets[k]).extended(degree); };
+
+  std::vector<PermSet> strong_generators(factors.size());
+
+  for (auto k = 0u; k < factors.size(); ++k) {
+    for (Perm const &gen : factors[k].strong_generators())
+      strong_generators[k].insert(lift(gen, k));
+  }
+
+  BSGS bsgs(degree);
+
+  for (auto const &sgs : strong_generators)
+    bsgs._strong_generators.insert(sgs.begin(), sgs.end());
+
+  if (bsgs._strong_generators.empty())
+    return bsgs;
+
+  bsgs.transversals_init(&options);
+
+  // concatenate factor bases
+  std::vector<unsigned> base_offsets;
+
+  for (auto k = 0u; k < factors.size(); ++k) {
+    base_offsets.push_back(bsgs.base_size());
+
+    for (unsigned bp : factors[k].base())
+      bsgs._base.push_back(bp + offsets[k]);
+  }
+
+  for (unsigned i = 0u; i < bsgs.base_size(); ++i)
+    bsgs.reserve_schreier_structure(i);
+
+  // build the Schreier structures of every level from the corresponding factor
+  // level's generators only, the strong generators of all following factors
+  // fix the level's orbit pointwise and are merely added as labels, since
+  // levels are later rebuilt from their labels alone (e.g. during base
+  // changes) these must be closed under inversion, in order to keep the
+  // number of stored labels linear in the number of factors, the factors'
+  // strong generators are concatenated in reverse order such that the labels
+  // of all levels belonging to one factor form a prefix of one shared set
+  auto strong_generators_following(std::make_shared<PermSet>());
+  std::vector<unsigned> num_strong_generators_following(factors.size());
+
+  for (auto k = factors.size(); k-- > 0u;) {
+    num_strong_generators_following[k] = strong_generators_following->size();
+
+    auto strong_generators_with_inverses(strong_generators[k].with_inverses());
+
+    strong_generators_following->insert(strong_generators_with_inverses.begin(),
+                                        strong_generators_with_inverses.end());
+  }
+
+  for (auto k = 0u; k < factors.size(); ++k) {
+    auto const &factor = factors[k];
+
+    for (unsigned i = 0u; i < factor.base_size(); ++i) {
+      PermSet stabilizers;
+      for (Perm const &stab : factor.stabilizers(i))
+        stabilizers.insert(lift(stab, k));
+
+      bsgs.update_schreier_structure(base_offsets[k] + i,
+                                     stabilizers,
+                                     strong_generators_following,
+                                     num_strong_generators_following[k]);
+    }
+  }
+
+  DBG(DEBUG) << "=> B = " << bsgs._base;
+  DBG(DEBUG) << "=> SGS = " << bsgs._strong_generators;
+
+  return bsgs;
+}
+
+BSGS BSGS::wreath_product(BSGS const &lhs,
+                          BSGS const &rhs,
+                          BSGSOptions const *options_)
+{
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  DBG(DEBUG) << "Constructing wreath product BSGS";
+
+  unsigned block_size = lhs.degree();
+  unsigned num_blocks = rhs.degree();
+  unsigned degree = block_size * num_blocks;
+
+  // lhs acts on every block, rhs permutes the blocks
+  auto lift_lhs = [&](Perm const &perm, unsigned block)
+  { return perm.shifted(block * block_size).extended(degree); };
+
+  auto lift_rhs = [&](Perm const &perm)
+  {
+    std::vector<unsigned> perm_lifted(degree);
+    for (unsigned b = 0u; b < num_blocks; ++b) {
+      for (unsigned x = 0u; x < block_size; ++x)
+        perm_lifted[b * block_size + x] = perm[b] * block_size + x;
+    }
+
+    return Perm(perm_lifted);
+  };
+
+  auto lift_lhs_diagonal = [&](Perm const &perm)
+  {
+    std::vector<unsigned> perm_lifted(degree);
+    for (unsigned b = 0u; b < num_blocks; ++b) {
+      for (unsigned x = 0u; x < block_size; ++x)
+        perm_lifted[b * block_size + x] = b * block_size + perm[x];
+    }
+
+    return Perm(perm_lifted);
+  };
+
+  BSGS bsgs(degree);
+
+  if (lhs.base_empty() && rhs.base_empty())
+    return bsgs;
+
+  bsgs.transversals_init(&options);
+
+  // if rhs is trivial, lhs acts diagonally on all blocks
+  if (rhs.base_empty()) {
+    for (unsigned i = 0u; i < lhs.base_size(); ++i) {
+      bsgs._base.push_back(lhs.base_point(i));
+
+      PermSet stabilizers;
+      for (Perm const &stab : lhs.stabilizers(i))
+        stabilizers.insert(lift_lhs_diagonal(stab));
+
+      bsgs.update_schreier_structure(i, stabilizers);
+    }
+
+    for (Perm const &gen : lhs.strong_generators())
+      bsgs._strong_generators.insert(lift_lhs_diagonal(gen));
+
+    return bsgs;
+  }
+
+  // lhs generators lifted into every block
+  std::vector<PermSet> lhs_generators(num_blocks);
+
+  if (!lhs.base_empty()) {
+    for (unsigned b = 0u; b < num_blocks; ++b) {
+      for (Perm const &gen : lhs.stabilizers(0))
+        lhs_generators[b].insert(lift_lhs(gen, b));
+    }
+  }
+
+  auto rhs_stabilizers = [&](unsigned i)
+  {
+    PermSet stabilizers;
+    if (i < rhs.base_size()) {
+      for (Perm const &stab : rhs.stabilizers(i))
+        stabilizers.insert(lift_rhs(stab));
+    }
+
+    return stabilizers;
+  };
+
+  // the blocks corresponding to the rhs base points come first, once the lhs
+  // base points in the first i such blocks are fixed, the remaining group is
+  // lhs in all other blocks extended by the i-th rhs point stabilizer
+  std::vector<unsigned> blocks(rhs.base());
+  std::vector<bool> blocks_fixed(num_blocks, false);
+
+  for (unsigned b = 0u; b < num_blocks; ++b) {
+    if (std::find(blocks.begin(), blocks.end(), b) == blocks.end())
+      blocks.push_back(b);
+  }
+
+  for (unsigned t = 0u; t < blocks.size(); ++t) {
+    unsigned block = blocks[t];
+
+    std::vector<bool> blocks_orbit(num_blocks, false);
+    if (t < rhs.base_size()) {
+      for (unsigned b : rhs.orbit(t))
+        blocks_orbit[b] = true;
+    } else {
+      blocks_orbit[block] = true;
+    }
+
+    if (lhs.base_empty()) {
+      if (t < rhs.base_size()) {
+        bsgs._base.push_back(block * block_size);
+        bsgs.update_schreier_structure(bsgs.base_size() - 1u,
+                                       rhs_stabilizers(t));
+      }
+
+      continue;
+    }
+
+    for (unsigned i = 0u; i < lhs.base_size(); ++i) {
+      bsgs._base.push_back(block * block_size + lhs.base_point(i));
+
+      PermSet generators, generators_fixing_orbit;
+
+      if (i == 0u) {
+        generators = rhs_stabilizers(t);
+
+        for (unsigned b = 0u; b < num_blocks; ++b) {
+          if (blocks_fixed[b])
+            continue;
+
+          auto &dest(blocks_orbit[b] ? generators : generators_fixing_orbit);
+          dest.insert(lhs_generators[b].begin(), lhs_generators[b].end());
+        }
+
+      } else {
+        for (Perm const &stab : lhs.stabilizers(i))
+          generators.insert(lift_lhs(stab, block));
+
+        generators_fixing_orbit = rhs_stabilizers(t + 1u);
+
+        for (unsigned b = 0u; b < num_blocks; ++b) {
+          if (blocks_fixed[b] || b == block)
+            continue;
+
+          generators_fixing_orbit.insert(lhs_generators[b].begin(),
+                                         lhs_generators[b].end());
+        }
+      }
+
+      bsgs.update_schreier_structure(bsgs.base_size() - 1u,
+                                     generators,
+                                     generators_fixing_orbit);
+    }
+
+    blocks_fixed[block] = true;
+  }
+
+  for (auto const &gens : lhs_generators)
+    bsgs._strong_generators.insert(gens.begin(), gens.end());
+
+  for (Perm const &gen : rhs.strong_generators())
+    bsgs._strong_generators.insert(lift_rhs(gen));
+
+  DBG(DEBUG) << "=> B = " << bsgs._base;
+  DBG(DEBUG) << "=> SGS = " << bsgs._strong_generators;
+
+  return bsgs;
+}
+
+} // namespace internal
+
+} // namespace mpsym
@@ -1,5 +1,6 @@
 #include <algorithm>
-#include <unordered_set>
+#include <cassert>
+#include <utility>
 #include <vector>
 
 #include "bsgs.hpp"
@@ -18,103 +19,133 @@ void BSGS::reduce_gens()
 {
   DBG(DEBUG) << "Removing redundant strong generators";
 
-  std::unordered_set<Perm> strong_generator_set(_strong_generators.begin(),
-                                                _strong_generators.end());
+  // every non-trivial strong generator is a candidate for removal at exactly
+  // one level, namely that of the first base point it moves
+  std::vector<std::vector<unsigned>> candidates(base_size());
 
-  std::unordered_set<Perm> stabilizer_set;
-  std::unordered_set<Perm> stabilizer_intersection;
+  for (unsigned j = 0u; j < _strong_generators.size(); ++j) {
+    Perm const &sg = _strong_generators[j];
 
-  for (int i = static_cast<int>(base_size() - 1u); i >= 0; --i) {
-    auto stabilizer_vect(stabilizers(i));
+    for (unsigned i = 0u; i < base_size(); ++i) {
+      if (sg[base_point(i)] != base_point(i)) {
+        candidates[i].push_back(j);
+        break;
+      }
+    }
+  }
 
-    std::unordered_set<Perm> stabilizer_set_next(stabilizer_vect.begin(),
-                                                 stabilizer_vect.end());
+  // the strong generators retained so far all fix the base points up to and
+  // including the current one, starting from the last level, each level's
+  // candidates are only retained if they join two classes of the partition
+  // of the fundamental orbit induced by all previously retained generators
+  std::vector<unsigned> retained;
 
-    stabilizer_intersection = reduce_gens_set_difference(stabilizer_set_next,
-                                                         stabilizer_set,
-                                                         strong_generator_set);
+  std::vector<unsigned> classpath(degree());
+  std::vector<unsigned> cardinalities(degree());
 
-    stabilizer_set = stabilizer_set_next;
+  for (int i = static_cast<int>(base_size() - 1u); i >= 0; --i) {
+    DBG(TRACE) << "Considering S(" << i + 1u << ")/S(" << i + 2u << ")";
 
-    DBG(TRACE) << "Considering S(" << i + 1u << ")/S(" << i + 2u << ")"
-               << " = " << stabilizer_intersection;
+    auto orbit_i(orbit(i));
 
-    if (stabilizer_intersection.size() < 2u)
-      continue;
+    for (unsigned x : orbit_i) {
+      classpath[x] = x;
+      cardinalities[x] = 1u;
+    }
 
-    auto it(stabilizer_intersection.begin());
-    while (it != stabilizer_intersection.end()) {
-      DBG(TRACE) << "Considering " << *it;
+    unsigned num_classes = orbit_i.size();
 
-#ifndef NDEBUG
-      std::unordered_set<Perm> reduced_stabilizers(stabilizer_set);
+    for (unsigned j : retained) {
+      Perm const &sg = _strong_generators[j];
 
-      auto it_(reduced_stabilizers.begin());
-      while (it_ != reduced_stabilizers.end()) {
-        if (*it_ == *it) {
-          reduced_stabilizers.erase(it_++);
-          break;
-        } else {
-          ++it_;
-        }
+      for (unsigned x : orbit_i) {
+        if (reduce_gens_merge_classes(x, sg[x], classpath, cardinalities))
+          --num_classes;
       }
-#endif
-      PermSet orbit_gens(stabilizer_set.begin(), stabilizer_set.end());
-      orbit_gens.erase(*it);
+    }
 
-      bool remove_stab = false;
-      if (orbit(i).generated_by(base_point(i), orbit_gens)) {
-#ifndef NDEBUG
-        DBG(TRACE) << base_point(i) << "^" << reduced_stabilizers
-                   << " = " << orbit(i);
-#endif
+    for (unsigned j : candidates[i]) {
+      Perm const &sg = _strong_generators[j];
 
-        DBG(TRACE) << "Removing strong generator " << *it;
+      bool merged = false;
 
-        remove_stab = true;
-      }
-#ifndef NDEBUG
-      else {
-        DBG(TRACE) << base_point(i) << "^" << reduced_stabilizers
-                   << " =/= " << orbit(i);
+      if (num_classes > 1u) {
+        for (unsigned x : orbit_i) {
+          if (reduce_gens_merge_classes(x, sg[x], classpath, cardinalities)) {
+            merged = true;
+            --num_classes;
+          }
+        }
       }
-#endif
-
-      if (remove_stab) {
-        strong_generator_set.erase(*it);
-        stabilizer_set.erase(*it);
-#ifndef NDEBUG
-        reduced_stabilizers.erase(*it);
-#endif
-        stabilizer_intersection.erase(it++);
+
+      if (merged) {
+        retained.push_back(j);
       } else {
-        ++it;
+        DBG(TRACE) << "Removing strong generator " << sg;
       }
     }
+
+    assert(num_classes == 1u);
   }
 
-  _strong_generators = PermSet(strong_generator_set.begin(),
-                               strong_generator_set.end());
+  std::sort(retained.begin(), retained.end());
+
+  PermSet strong_generators;
+  for (unsigned j : retained)
+    strong_generators.insert(_strong_generators[j]);
+
+  _strong_generators = strong_generators;
 
   DBG(DEBUG) << "Reduced BSGS:";
   DBG(DEBUG) << *this;
 }
 
-std::unordered_set<Perm> BSGS::reduce_gens_set_difference(
-  std::unordered_set<Perm> const &lhs,
-  std::unordered_set<Perm> const &rhs,
-  std::unordered_set<Perm> const &base) const
+unsigned BSGS::reduce_gens_find_rep(unsigned k,
+                                    std::vector<unsigned> &classpath)
 {
-  std::unordered_set<Perm> res;
+  // find class
+  unsigned res = k;
+  unsigned next = classpath[res];
+
+  while (next != res) {
+    res = next;
+    next = classpath[res];
+  }
 
-  for (auto const &perm : lhs) {
-    if (rhs.find(perm) == rhs.end() && base.find(perm) != base.end())
-      res.insert(perm);
+  // compress path
+  unsigned current = k;
+  next = classpath[k];
+
+  while (next != current) {
+    classpath[current] = res;
+
+    current = next;
+    next = classpath[current];
   }
 
   return res;
 }
 
+bool BSGS::reduce_gens_merge_classes(unsigned k1,
+                                     unsigned k2,
+                                     std::vector<unsigned> &classpath,
+                                     std::vector<unsigned> &cardinalities)
+{
+  unsigned r1 = reduce_gens_find_rep(k1, classpath);
+  unsigned r2 = reduce_gens_find_rep(k2, classpath);
+
+  if (r1 == r2)
+    return false;
+
+  if (cardinalities[r1] < cardinalities[r2])
+    std::swap(r1, r2);
+
+  classpath[r2] = r1;
+  cardinalities[r1] += cardinalities[r2];
+
+  return true;
+}
+
 } // namespace internal
 
 } // namespace mpsym
@@ -42,15 +42,51 @@ void BSGS::schreier_sims(PermSet const &generators,
 
 void BSGS::schreier_sims(std::vector<PermSet> &strong_generators,
                          std::vector<Orbit> &fundamental_orbits,
-                         BSGSOptions const *,
-                         timeout::flag aborted)
+                         BSGSOptions const *options_,
+                         timeout::flag aborted,
+                         int level)
+{
+  auto options(BSGSOptions::fill_defaults(options_));
+
+  unsigned subset = options.schreier_sims_schreier_generator_subset;
+
+  if (subset > 0u) {
+    DBG(TRACE) << "Iterating over random subsets of Schreier Generators";
+
+    int level_touched = schreier_sims_main(
+      strong_generators, fundamental_orbits, &options, aborted, level, subset);
+
+    if (level >= 0)
+      level = std::max(level, level_touched);
+
+    DBG(TRACE) << "Verifying result";
+  }
+
+  schreier_sims_main(
+    strong_generators, fundamental_orbits, &options, aborted, level, 0u);
+
+  schreier_sims_finish();
+}
+
+int BSGS::schreier_sims_main(std::vector<PermSet> &strong_generators,
+                             std::vector<Orbit> &fundamental_orbits,
+                             BSGSOptions const *options,
+                             timeout::flag aborted,
+                             int level,
+                             unsigned subset)
 {
-  std::vector<SchreierGeneratorQueue> schreier_generator_queues(base_size());
+  bool dedupe = options->schreier_sims_dedupe_schreier_generators;
+
+  std::vector<SchreierGeneratorQueue> schreier_generator_queues(
+    base_size(),
+    SchreierGeneratorQueue(dedupe, subset, options->random_engine));
+
+  int level_touched = level;
 
   DBG(TRACE) << "Iterating over Schreier Generators";
 
-  // main loop
-  unsigned i = base_size();
+  // main loop, all levels beyond 'level' are assumed to already be complete
+  unsigned i = level < 0 ? base_size() : static_cast<unsigned>(level) + 1u;
   while (i >= 1u) {
     if (timeout::is_set(aborted))
       throw timeout::AbortedError("schreier_sims");
@@ -62,9 +98,6 @@ top:
                                             schreier_structure(i - 1));
 
     for (Perm const &schreier_generator : schreier_generator_queues[i - 1]) {
-      if (schreier_generator.id())
-        continue;
-
       DBG(TRACE) << "Schreier Generator: " << schreier_generator;
 
       // strip
@@ -120,9 +153,12 @@ top:
 
         TIMER_STOP("update strong gens");
 
+        level_touched = std::max(level_touched, static_cast<int>(i));
+
         // update schreier generator queue
         if (do_extend_base)
-          schreier_generator_queues.emplace_back();
+          schreier_generator_queues.emplace_back(
+            dedupe, subset, options->random_engine);
         else
           schreier_generator_queues[i].invalidate();
 
@@ -135,7 +171,7 @@ top:
     --i;
   }
 
-  schreier_sims_finish();
+  return level_touched;
 }
 
 void BSGS::schreier_sims_random(PermSet const &generators,
@@ -201,7 +237,7 @@ void BSGS::schreier_sims_random(std::vector<PermSet> &strong_generators,
                                 timeout::flag aborted)
 {
   // random group element generator
-  PrRandomizer pr(_strong_generators);
+  PrRandomizer pr(_strong_generators, options->random_engine);
 
   unsigned c = 0u;
   while (c < options->schreier_sims_random_w) {
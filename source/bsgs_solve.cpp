@@ -65,7 +65,10 @@ bool BSGS::solve_s_normal_closure(PermSet const &generators,
 {
   DBG(TRACE) << "Begin calculating S-Normal Closure";
 
-  BSGS const original_bsgs(*this);
+  // instead of copying the complete BSGS, only record what is needed to
+  // restore it if the normal closure turns out not to be abelian modulo the
+  // current group
+  auto checkpoint(solve_checkpoint());
 
   PermSet queue1 {w};
   PermSet queue2;
@@ -79,7 +82,7 @@ bool BSGS::solve_s_normal_closure(PermSet const &generators,
 
       for (auto const &h : queue2) {
         Perm tmp(~g * ~h * g * h);
-        if (!original_bsgs.strips_completely(tmp)) {
+        if (!solve_strips_completely_checkpoint(tmp, checkpoint)) {
           DBG(TRACE) << ~g << " * " << ~h << " * " << g << " * " << h
                      << " = " << tmp << " not in original BSGS";
 
@@ -89,6 +92,8 @@ bool BSGS::solve_s_normal_closure(PermSet const &generators,
           conjugates.first = g;
           conjugates.second = h;
 
+          solve_rollback(checkpoint);
+
           return false;
         }
 #ifndef NDEBUG
@@ -99,7 +104,7 @@ bool BSGS::solve_s_normal_closure(PermSet const &generators,
 #endif
       }
 
-      solve_adjoin_normalizing_generator(g);
+      solve_adjoin_normalizing_generator(g, checkpoint);
 
       queue2.insert(g);
 
@@ -123,7 +128,8 @@ bool BSGS::solve_s_normal_closure(PermSet const &generators,
   return true;
 }
 
-void BSGS::solve_adjoin_normalizing_generator(Perm const &gen)
+void BSGS::solve_adjoin_normalizing_generator(Perm const &gen,
+                                              SolveCheckpoint &checkpoint)
 {
   DBG(TRACE) << "Begin adjoining normalizing generator";
   DBG(TRACE) << "Generator is: " << gen;
@@ -136,20 +142,20 @@ void BSGS::solve_adjoin_normalizing_generator(Perm const &gen)
     DBG(TRACE) << "Iteration " << i;
 
     if (i > base_size()) {
-      for (unsigned j = 1u; j <= degree(); ++j) {
+      for (unsigned j = 0u; j < degree(); ++j) {
         if (h[j] != j) {
-          extend_base(i);
+          extend_base(j);
           break;
         }
       }
 
+      reserve_schreier_structure(i - 1u);
+
       DBG(TRACE) << ">>> Updated base: " << _base << " <<<";
     }
 
     unsigned base_elem = base_point(i - 1u);
 
-    throw std::logic_error("TODO: schreier structure initialization");
-
     DBG(TRACE)
       << "Considering h = " << h << " and b_" << i << " = " << base_elem
       << " (with orbit " << schreier_structure(i - 1u)->nodes() << ")";
@@ -175,8 +181,12 @@ void BSGS::solve_adjoin_normalizing_generator(Perm const &gen)
       DBG(TRACE) << "Enlarging:";
 
       for (unsigned j = 0u; j < i; ++j) { // TODO: avoid complete recomputation
+        if (j < checkpoint.base_size && !checkpoint.replaced[j])
+          checkpoint.replaced[j] = schreier_structure(j);
+
         PermSet s_j(schreier_structure(j)->labels());
         s_j.insert(h);
+        s_j.insert(~h);
 
         update_schreier_structure(j, s_j);
 
@@ -194,6 +204,51 @@ void BSGS::solve_adjoin_normalizing_generator(Perm const &gen)
   DBG(TRACE) << "Finished adjoining normalizing generator";
 }
 
+BSGS::SolveCheckpoint BSGS::solve_checkpoint() const
+{
+  SolveCheckpoint checkpoint;
+  checkpoint.base_size = base_size();
+  checkpoint.num_strong_generators = _strong_generators.size();
+  checkpoint.replaced.resize(base_size());
+
+  return checkpoint;
+}
+
+void BSGS::solve_rollback(SolveCheckpoint const &checkpoint)
+{
+  DBG(TRACE) << "Rolling back BSGS to base size " << checkpoint.base_size;
+
+  _base.resize(checkpoint.base_size);
+  _transversals->truncate(checkpoint.base_size);
+
+  for (unsigned i = 0u; i < checkpoint.base_size; ++i) {
+    if (checkpoint.replaced[i])
+      _transversals->restore_schreier_structure(i, checkpoint.replaced[i]);
+  }
+
+  _strong_generators.resize(checkpoint.num_strong_generators);
+}
+
+bool BSGS::solve_strips_completely_checkpoint(
+  Perm const &perm, SolveCheckpoint const &checkpoint) const
+{
+  // strip through the stabilizer chain as it was when the checkpoint was taken
+  Perm result(perm);
+
+  for (unsigned i = 0u; i < checkpoint.base_size; ++i) {
+    auto ss(checkpoint.replaced[i] ? checkpoint.replaced[i]
+                                   : schreier_structure(i));
+
+    unsigned beta = result[base_point(i)];
+    if (!ss->contains(beta))
+      return false;
+
+    result *= ~ss->transversal(beta);
+  }
+
+  return result.id();
+}
+
 } // namespace internal
 
 } // namespace mpsym
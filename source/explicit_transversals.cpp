@@ -1,3 +1,4 @@
+#include <cassert>
 #include <ostream>
 #include <vector>
 
@@ -19,6 +20,8 @@ void ExplicitTransversals::create_edge(
   } else {
     _orbit[origin] = _orbit[destination] * _labels[label];
   }
+
+  _edge_labels[origin] = label;
 }
 
 unsigned ExplicitTransversals::root() const
@@ -29,15 +32,23 @@ unsigned ExplicitTransversals::root() const
 std::vector<unsigned> ExplicitTransversals::nodes() const
 {
   std::vector<unsigned> res;
-  for (auto item : _orbit)
+  for (auto const &item : _orbit)
     res.push_back(item.first);
 
   return res;
 }
 
+unsigned ExplicitTransversals::size() const
+{
+  return _orbit.size();
+}
+
 PermSet ExplicitTransversals::labels() const
 {
-  return _labels;
+  PermSet res(_labels);
+  insert_labels_fixing_orbit(res);
+
+  return res;
 }
 
 bool ExplicitTransversals::contains(unsigned node) const
@@ -45,9 +56,15 @@ bool ExplicitTransversals::contains(unsigned node) const
   return _orbit.find(node) != _orbit.end();
 }
 
-bool ExplicitTransversals::incoming(unsigned, Perm const &) const
+bool ExplicitTransversals::incoming(unsigned node, Perm const &edge) const
 {
-  return false;
+  assert(edge.degree() == _degree);
+
+  auto it = _edge_labels.find(edge[node]);
+  if (it == _edge_labels.end())
+    return false;
+
+  return _labels[it->second] == edge;
 }
 
 Perm ExplicitTransversals::transversal(unsigned origin) const
@@ -44,6 +44,16 @@ void _save_gens(int, int *perm, int *, int, int, int)
   _gens.emplace(tmp);
 }
 
+std::vector<unsigned> _orbit_lengths;
+
+void _save_orbit_length(int *, int *, int, int *, statsblk *, int, int index,
+                        int, int, int, int)
+{
+  // index is the length of the orbit of the level's target vertex under the
+  // pointwise stabilizer of all previous target vertices
+  _orbit_lengths.push_back(static_cast<unsigned>(index));
+}
+
 } // anonymous namespace
 
 namespace mpsym
@@ -146,9 +156,28 @@ void NautyGraph::set_partition(std::vector<std::vector<int>> const &ptn)
 }
 
 PermSet NautyGraph::automorphism_generators()
+{
+  _gens.clear();
+  _gen_degree = _n_reduced;
+
+  call_nauty(true);
+
+  return _gens;
+}
+
+std::vector<unsigned> NautyGraph::automorphism_orbit_lengths()
+{
+  _orbit_lengths.clear();
+
+  call_nauty(false);
+
+  return _orbit_lengths;
+}
+
+void NautyGraph::call_nauty(bool save_generators)
 {
   if (_edges.empty())
-    return {};
+    return;
 
   // construct (sparse) nauty graph
   sparsegraph sg;
@@ -192,20 +221,19 @@ PermSet NautyGraph::automorphism_generators()
                                   : nauty_options_undirected;
 
   nauty_options.defaultptn = _ptn_expl.empty() ? TRUE : FALSE;
-  nauty_options.userautomproc = _save_gens;
 
-  // call nauty
-  _gens.clear();
-  _gen_degree = _n_reduced;
+  // only record what was asked for, determining the group order alone does
+  // not require storing any generators
+  nauty_options.userautomproc = save_generators ? _save_gens : nullptr;
+  nauty_options.userlevelproc = save_generators ? nullptr : _save_orbit_length;
 
+  // call nauty
   statsblk stats;
   sparsenauty(&sg, _lab, _ptn, _orbits, &nauty_options, &stats, nullptr);
 
   // free memory
   SG_FREE(sg);
   nausparse_freedyn();
-
-  return _gens;
 }
 
 } // namespace internal
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <random>
 #include <stdexcept>
@@ -51,67 +52,36 @@ bool PermGroup::operator!=(PermGroup const &rhs) const
 
 PermGroup PermGroup::symmetric(unsigned degree)
 {
-  // TODO: explicit BSGS
-
   assert(degree > 0u);
 
-  if (degree == 1u)
-    return PermGroup(1u, {Perm(1u)});
+  return PermGroup(BSGS::symmetric(degree));
+}
 
-  std::vector<unsigned> gen;
-  for (unsigned i = 0u; i < degree; ++i)
-    gen.push_back(i);
+PermGroup PermGroup::alternating(unsigned degree)
+{
+  assert(degree > 0u);
 
-  return PermGroup(degree, {Perm(degree, {{0, 1}}), Perm(degree, {gen})});
+  return PermGroup(BSGS::alternating(degree));
 }
 
 PermGroup PermGroup::cyclic(unsigned degree)
 {
-  // TODO: explicit BSGS
-
   assert(degree > 0u);
 
-  std::vector<unsigned> gen;
-  for (unsigned i = 0u; i < degree; ++i)
-    gen.push_back(i);
-
-  return PermGroup(degree, {Perm(degree, {gen})});
+  return PermGroup(BSGS::cyclic(degree));
 }
 
 PermGroup PermGroup::dihedral(unsigned degree)
 {
-  // TODO: explicit BSGS
-
   assert(degree > 0u && degree % 2 == 0);
 
   if (degree == 2u)
-    return PermGroup(2, {Perm({1, 0})});
+    return PermGroup(BSGS::symmetric(2u));
 
   if (degree == 4u)
     return PermGroup(4, {Perm({1, 0, 2, 3}), Perm({0, 1, 3, 2})});
 
-  std::vector<unsigned> rotation(degree / 2u);
-
-  // rotation
-  for (unsigned i = 0u; i < degree / 2u - 1u; ++i)
-    rotation[i] = i + 1u;
-
-  rotation[degree / 2u - 1u] = 0u;
-
-  // reflection
-  std::vector<unsigned> reflection(degree / 2u);
-
-  reflection[0] = 0u;
-
-  for (unsigned i = 1u; i < (degree / 2u + 1u) / 2u; ++i) {
-    reflection[i] = degree / 2u - i;
-    reflection[degree / 2u - i] = i;
-  }
-
-  if ((degree / 2u) % 2 == 0)
-    reflection[degree / 4u] = degree / 4u;
-
-  return PermGroup(degree / 2u, {Perm(rotation), Perm(reflection)});
+  return PermGroup(BSGS::dihedral(degree / 2u));
 }
 
 PermSet PermGroup::wreath_product_generators(PermGroup const &lhs,
@@ -170,26 +140,11 @@ PermSet PermGroup::wreath_product_generators(PermGroup const &lhs,
 
 PermGroup PermGroup::wreath_product(PermGroup const &lhs,
                                     PermGroup const &rhs,
-                                    BSGSOptions const *bsgs_options_,
-                                    timeout::flag aborted)
+                                    BSGSOptions const *bsgs_options,
+                                    timeout::flag)
 {
-  // degree of wreath product
-  unsigned wp_degree = lhs.degree() * rhs.degree();
-
-  // generators of wreath product
-  auto wp_generators(wreath_product_generators(lhs, rhs));
-
-  if (wp_generators.empty())
-    return PermGroup(wp_degree);
-
-  // order of wreath product
-  auto wp_order(wreath_product_order(lhs, rhs));
-
-  // construct wreath product
-  auto bsgs_options(BSGSOptions::fill_defaults(bsgs_options_));
-  bsgs_options.schreier_sims_random_known_order = wp_order;
-
-  return PermGroup(BSGS(wp_degree, wp_generators, &bsgs_options, aborted));
+  // the wreath product's BSGS is assembled from the factors' BSGSs
+  return PermGroup(BSGS::wreath_product(lhs.bsgs(), rhs.bsgs(), bsgs_options));
 }
 
 BSGS::order_type PermGroup::wreath_product_order(PermGroup const &lhs,
@@ -238,9 +193,95 @@ bool PermGroup::contains_element(Perm const &perm) const
   return _bsgs.strips_completely(perm);
 }
 
-Perm PermGroup::random_element() const
+std::vector<bool> PermGroup::contains_elements(std::vector<Perm> const &perms,
+                                               unsigned num_threads) const
 {
-  static auto re(util::random_engine());
+  return _bsgs.strips_completely(perms, num_threads);
+}
+
+std::shared_ptr<BSGS const> PermGroup::bsgs(std::vector<unsigned> const &prefix,
+                                            BSGSOptions const *bsgs_options) const
+{
+  // the group's own BSGS is not owned by the returned pointer
+  if (is_trivial() || _bsgs.has_base_prefix(prefix))
+    return std::shared_ptr<BSGS const>(std::shared_ptr<BSGS const>(), &_bsgs);
+
+  // start the base change from the BSGS sharing the longest base prefix with
+  // the requested one, prefixes are often requested incrementally
+  std::shared_ptr<BSGS const> closest;
+
+  {
+    std::lock_guard<std::mutex> lock(_base_change_cache.mutex);
+
+    auto cached(base_change_cache_find(prefix, &closest));
+    if (cached)
+      return cached;
+  }
+
+  // the base change itself is performed without holding the lock so that
+  // concurrent callers requesting different prefixes are not serialized
+  auto res(std::make_shared<BSGS>(
+    (closest ? *closest : _bsgs).with_base_prefix(prefix, bsgs_options)));
+
+  std::lock_guard<std::mutex> lock(_base_change_cache.mutex);
+
+  // another thread might have performed the same base change in the meantime
+  auto cached(base_change_cache_find(prefix));
+  if (cached)
+    return cached;
+
+  auto &entries(_base_change_cache.entries);
+
+  entries.push_front(res);
+
+  if (entries.size() > base_change_cache_size)
+    entries.pop_back();
+
+  return res;
+}
+
+std::shared_ptr<BSGS const> PermGroup::base_change_cache_find(
+  std::vector<unsigned> const &prefix,
+  std::shared_ptr<BSGS const> *closest) const
+{
+  // the cache's mutex must be held by the caller
+  auto &entries(_base_change_cache.entries);
+
+  auto closest_common(base_prefix_common(_bsgs, prefix));
+
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if ((*it)->has_base_prefix(prefix)) {
+      entries.splice(entries.begin(), entries, it);
+      return entries.front();
+    }
+
+    if (closest) {
+      auto common(base_prefix_common(**it, prefix));
+      if (common > closest_common) {
+        *closest = *it;
+        closest_common = common;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+std::size_t PermGroup::base_prefix_common(BSGS const &bsgs,
+                                          std::vector<unsigned> const &prefix)
+{
+  std::size_t common = 0u;
+  while (common < prefix.size() && common < bsgs.base_size() &&
+         bsgs.base_point(common) == prefix[common]) {
+    ++common;
+  }
+
+  return common;
+}
+
+Perm PermGroup::random_element(util::random_engine_type *re_) const
+{
+  auto &re(util::random_engine_or_default(re_));
 
   Perm result(degree());
   for (unsigned i = 0u; i < _bsgs.base_size(); ++i) {
@@ -254,20 +295,34 @@ Perm PermGroup::random_element() const
   return result;
 }
 
+PermGroup PermGroup::closure(PermSet const &generators,
+                             BSGSOptions const *bsgs_options,
+                             timeout::flag aborted) const
+{
+  BSGS bsgs(_bsgs);
+  bsgs.extend(generators, bsgs_options, aborted);
+
+  return PermGroup(bsgs);
+}
+
 PermGroup::const_iterator::const_iterator(PermGroup const &pg)
-  : _trivial(pg.bsgs().base_empty()),
+  : const_iterator(pg.bsgs())
+{}
+
+PermGroup::const_iterator::const_iterator(BSGS const &bsgs)
+  : _trivial(bsgs.base_empty()),
     _end(false)
 {
   if (_trivial) {
-    _current = Perm(pg.degree());
+    _current = Perm(bsgs.degree());
 
     _current_valid = true;
 
   } else {
-    for (unsigned i = 0u; i < pg.bsgs().base_size(); ++i) {
+    for (unsigned i = 0u; i < bsgs.base_size(); ++i) {
       _state.push_back(0u);
 
-      auto transv = pg.bsgs().transversals(i);
+      auto transv = bsgs.transversals(i);
 
       _transversals.push_back(transv);
       _current_factors.insert(transv[0]);
@@ -314,19 +369,36 @@ void PermGroup::const_iterator::next()
     return;
   }
 
-  for (unsigned i = 0u; i < _state.size(); ++i) {
-    _state[i]++;
-    if (_state[i] == _transversals[i].size())
-      _state[i] = 0u;
+  skip(_state.size() - 1u);
+}
+
+void PermGroup::const_iterator::skip(unsigned i)
+{
+  if (_trivial) {
+    _end = true;
+    return;
+  }
+
+  assert(i < _state.size());
+
+  for (unsigned j = i + 1u; j < _state.size(); ++j) {
+    _state[j] = 0u;
+    _current_factors[j] = _transversals[j][0];
+  }
+
+  for (int j = static_cast<int>(i); j >= 0; --j) {
+    _state[j]++;
+    if (_state[j] == _transversals[j].size())
+      _state[j] = 0u;
 
-    _current_factors[i] = _transversals[i][_state[i]];
+    _current_factors[j] = _transversals[j][_state[j]];
 
-    if (i == _state.size() - 1u && _state[i] == 0u) {
+    if (j == 0 && _state[j] == 0u) {
       _end = true;
       break;
     }
 
-    if (_state[i] != 0u)
+    if (_state[j] != 0u)
       break;
   }
 
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <unordered_set>
@@ -21,9 +22,11 @@ namespace internal
 
 std::vector<PermGroup> PermGroup::disjoint_decomposition(
   bool complete,
-  bool disjoint_orbit_optimization) const
+  bool disjoint_orbit_optimization,
+  unsigned num_threads) const
 {
-  return complete ? disjoint_decomp_complete(disjoint_orbit_optimization)
+  return complete ? disjoint_decomp_complete(disjoint_orbit_optimization,
+                                             num_threads)
                   : disjoint_decomp_incomplete();
 }
 
@@ -91,10 +94,31 @@ void PermGroup::disjoint_decomp_generate_dependency_classes(
   }
 }
 
+OrbitPartition PermGroup::disjoint_decomp_orbit_split(
+  OrbitPartition const &orbits,
+  unsigned degree,
+  unsigned long long part)
+{
+  OrbitPartition orbit_split(degree);
+
+  for (unsigned x = 0u; x < degree; ++x) {
+    if (orbits.partition_index(x) == -1)
+      continue;
+
+    if ((1ULL << orbits.partition_index(x)) & part)
+      orbit_split.change_partition(x, 1);
+    else
+      orbit_split.change_partition(x, 0);
+  }
+
+  return orbit_split;
+}
+
 bool PermGroup::disjoint_decomp_restricted_subgroups(
   OrbitPartition const &orbit_split,
   PermGroup const &perm_group,
-  std::pair<PermGroup, PermGroup> &restricted_subgroups)
+  std::pair<PermGroup, PermGroup> &restricted_subgroups,
+  unsigned num_threads)
 {
   auto split1(orbit_split[0]);
   auto split2(orbit_split[1]);
@@ -118,11 +142,23 @@ bool PermGroup::disjoint_decomp_restricted_subgroups(
     restricted_generators2.insert(restricted_generator2);
   }
 
-  restricted_subgroups.first = PermGroup(perm_group.degree(),
-                                         restricted_generators1);
+  if (num_threads > 1u) {
+    auto restricted_subgroup1(std::async(std::launch::async, [&]{
+      return PermGroup(perm_group.degree(), restricted_generators1);
+    }));
+
+    restricted_subgroups.second = PermGroup(perm_group.degree(),
+                                            restricted_generators2);
 
-  restricted_subgroups.second = PermGroup(perm_group.degree(),
-                                          restricted_generators2);
+    restricted_subgroups.first = restricted_subgroup1.get();
+
+  } else {
+    restricted_subgroups.first = PermGroup(perm_group.degree(),
+                                           restricted_generators1);
+
+    restricted_subgroups.second = PermGroup(perm_group.degree(),
+                                            restricted_generators2);
+  }
 
   DBG(TRACE) << "Found disjoint subgroup decomposition:";
   DBG(TRACE) << restricted_subgroups.first;
@@ -144,48 +180,94 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_join_results(
 
 std::vector<PermGroup> PermGroup::disjoint_decomp_complete_recursive(
   OrbitPartition const &orbits,
-  PermGroup const &perm_group)
+  PermGroup const &perm_group,
+  unsigned num_threads)
 {
   // iterate over all possible partitions of the set of all orbits into two sets
   assert(orbits.num_partitions() < 8 * sizeof(unsigned long long));
 
-  for (auto part = 1ULL; !(part & (1ULL << (orbits.num_partitions() - 1u))); ++part) {
-    OrbitPartition orbit_split(perm_group.degree());
+  num_threads = std::max(num_threads, 1u);
 
-    for (unsigned x = 0u; x < perm_group.degree(); ++x) {
-      if (orbits.partition_index(x) == -1)
-        continue;
+  auto part_end = 1ULL << (orbits.num_partitions() - 1u);
 
-      if ((1ULL << orbits.partition_index(x)) & part)
-        orbit_split.change_partition(x, 1);
-      else
-        orbit_split.change_partition(x, 0);
+  // up to num_threads candidate splits are checked concurrently, of those that
+  // yield a decomposition the first one is chosen, so the result is the same
+  // as that of a sequential search
+  for (auto part = 1ULL; part < part_end; part += num_threads) {
+    unsigned batch_size = static_cast<unsigned>(
+      std::min(part_end - part, static_cast<unsigned long long>(num_threads)));
+
+    std::vector<OrbitPartition> orbit_splits;
+    orbit_splits.reserve(batch_size);
+
+    for (unsigned i = 0u; i < batch_size; ++i) {
+      orbit_splits.push_back(
+        disjoint_decomp_orbit_split(orbits, perm_group.degree(), part + i));
+
+      DBG(TRACE) << "Considering orbit split:";
+      DBG(TRACE) << orbit_splits.back();
     }
 
-    DBG(TRACE) << "Considering orbit split:";
-    DBG(TRACE) << orbit_split;
+    // try to find restricted subgroup decompositions
+    std::vector<std::pair<PermGroup, PermGroup>> restricted_subgroups(batch_size);
+    std::vector<int> decomposable(batch_size, 0);
+
+    if (batch_size == 1u) {
+      decomposable[0] = disjoint_decomp_restricted_subgroups(
+        orbit_splits[0], perm_group, restricted_subgroups[0], num_threads);
 
-    // try to find restricted subgroup decomposition
-    std::pair<PermGroup, PermGroup> restricted_subgroups;
+    } else {
+      std::vector<std::future<bool>> tasks;
+
+      for (unsigned i = 0u; i < batch_size; ++i) {
+        tasks.push_back(std::async(std::launch::async, [&, i]{
+          return disjoint_decomp_restricted_subgroups(
+            orbit_splits[i], perm_group, restricted_subgroups[i]);
+        }));
+      }
 
-    if (!disjoint_decomp_restricted_subgroups(
-          orbit_split, perm_group, restricted_subgroups))
+      for (unsigned i = 0u; i < batch_size; ++i)
+        decomposable[i] = tasks[i].get();
+    }
+
+    auto it(std::find(decomposable.begin(), decomposable.end(), 1));
+    if (it == decomposable.end())
       continue;
 
+    auto i(std::distance(decomposable.begin(), it));
+
     DBG(TRACE) << "Restricted groups are a disjoint subgroup decomposition";
 
     // recurse for both orbit partition elements and return combined result
-    auto orbits_recurse(orbits.split(orbit_split));
+    auto orbits_recurse(orbits.split(orbit_splits[i]));
 
     DBG(TRACE) << "Recursing with orbit partitions:";
     DBG(TRACE) << orbits_recurse[0];
     DBG(TRACE) << orbits_recurse[1];
 
-    return disjoint_decomp_join_results(
-      disjoint_decomp_complete_recursive(orbits_recurse[0],
-                                         restricted_subgroups.first),
-      disjoint_decomp_complete_recursive(orbits_recurse[1],
-                                         restricted_subgroups.second));
+    // both branches are independent and share the available threads
+    unsigned num_threads1 = num_threads / 2u;
+    unsigned num_threads2 = num_threads - num_threads1;
+
+    if (num_threads1 == 0u) {
+      return disjoint_decomp_join_results(
+        disjoint_decomp_complete_recursive(orbits_recurse[0],
+                                           restricted_subgroups[i].first),
+        disjoint_decomp_complete_recursive(orbits_recurse[1],
+                                           restricted_subgroups[i].second));
+    }
+
+    auto res1(std::async(std::launch::async, [&]{
+      return disjoint_decomp_complete_recursive(orbits_recurse[0],
+                                                restricted_subgroups[i].first,
+                                                num_threads1);
+    }));
+
+    auto res2(disjoint_decomp_complete_recursive(orbits_recurse[1],
+                                                 restricted_subgroups[i].second,
+                                                 num_threads2));
+
+    return disjoint_decomp_join_results(res1.get(), res2);
   }
 
   DBG(TRACE) << "No further decomposition possible, returning group";
@@ -194,7 +276,8 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_complete_recursive(
 }
 
 std::vector<PermGroup> PermGroup::disjoint_decomp_complete(
-  bool disjoint_orbit_optimization) const
+  bool disjoint_orbit_optimization,
+  unsigned num_threads) const
 {
   DBG(DEBUG) << "Finding (complete) disjoint subgroup decomposition for:";
   DBG(DEBUG) << *this;
@@ -212,7 +295,7 @@ std::vector<PermGroup> PermGroup::disjoint_decomp_complete(
     DBG(TRACE) << orbits;
   }
 
-  auto decomp(disjoint_decomp_complete_recursive(orbits, *this));
+  auto decomp(disjoint_decomp_complete_recursive(orbits, *this, num_threads));
 
   DBG(DEBUG) << "Found disjoint subgroup decomposition:";
   for (PermGroup const &pg : decomp)
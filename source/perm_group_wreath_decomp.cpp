@@ -21,6 +21,14 @@ std::vector<PermGroup> PermGroup::wreath_decomposition() const
   DBG(DEBUG) << "Finding wreath product decomposition for";
   DBG(DEBUG) << *this;
 
+  // the block systems considered below are only meaningful for transitive
+  // groups, and BlockSystem::non_trivial assumes transitivity when it
+  // recurses into the orbits of intransitive ones
+  if (!is_transitive()) {
+    DBG(DEBUG) << "=> Group is not transitive";
+    return {};
+  }
+
   for (BlockSystem const &block_system : BlockSystem::non_trivial(*this)) {
     DBG(TRACE) << "Considering block system:";
     DBG(TRACE) << block_system;
@@ -49,10 +57,15 @@ std::vector<PermGroup> PermGroup::wreath_decomposition() const
     if (!found_monomorphism)
       break;
 
+    PermGroup block_permuter_image_group(degree(), block_permuter_image);
+
+    if (!wreath_decomp_verify(block_permuter_image_group, stabilizers))
+      continue;
+
     // construct the wreath decomposition
     std::vector<PermGroup> decomposition(block_system.size() + 1u);
 
-    decomposition[0] = PermGroup(degree(), block_permuter_image);
+    decomposition[0] = block_permuter_image_group;
     for (unsigned i = 0u; i < block_system.size(); ++i)
       decomposition[i + 1u] = stabilizers[i];
 
@@ -132,7 +145,7 @@ PermSet PermGroup::wreath_decomp_construct_block_permuter_image(
       auto block(block_system[i]);
 
       for (auto j = 0u; j < block.size(); ++j)
-        perm[block[j] - 1u] = block_system[gen[i + 1u] - 1u][j];
+        perm[block[j]] = block_system[gen[i]][j];
     }
 
     block_permuter_image.insert(Perm(perm));
@@ -157,7 +170,7 @@ bool PermGroup::wreath_decomp_reconstruct_block_permuter(
     std::vector<unsigned> perm(block_system.size());
 
     for (unsigned i = 0u; i < block_system.size(); ++i)
-      perm[i] = block_system.block_index(gen[block_system[i][0]]) + 1u;
+      perm[i] = block_system.block_index(gen[block_system[i][0]]);
 
     Perm reconstructed_gen(perm);
 
@@ -185,6 +198,32 @@ bool PermGroup::wreath_decomp_reconstruct_block_permuter(
   return found_monomorphism;
 }
 
+bool PermGroup::wreath_decomp_verify(
+  PermGroup const &block_permuter_image,
+  std::vector<PermGroup> const &stabilizers) const
+{
+  // the heuristic monomorphism image maps onto the block permuter but is not
+  // necessarily contained in this group, in which case the factors do not
+  // generate it
+  for (Perm const &gen : block_permuter_image.generators()) {
+    if (!contains_element(gen)) {
+      DBG(TRACE) << "Heuristic monomorphism image not contained in group";
+      return false;
+    }
+  }
+
+  BSGS::order_type factors_order = block_permuter_image.order();
+  for (PermGroup const &stabilizer : stabilizers)
+    factors_order *= stabilizer.order();
+
+  if (factors_order != order()) {
+    DBG(TRACE) << "Factor orders do not multiply to group order";
+    return false;
+  }
+
+  return true;
+}
+
 } // namespace internal
 
 } // namespace mpsym
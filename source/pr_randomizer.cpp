@@ -12,6 +12,7 @@
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "pr_randomizer.hpp"
+#include "random.hpp"
 #include "util.hpp"
 
 namespace mpsym
@@ -21,9 +22,11 @@ namespace internal
 {
 
 PrRandomizer::PrRandomizer(PermSet const &generators,
+                           util::random_engine_type *re,
                            unsigned n_generators,
                            unsigned iterations)
-: _gens_orig(generators)
+: _re(re),
+  _gens_orig(generators)
 {
   generators.assert_not_empty();
 
@@ -50,7 +53,7 @@ PrRandomizer::PrRandomizer(PermSet const &generators,
 
 Perm PrRandomizer::next()
 {
-  static auto re(util::random_engine());
+  auto &re(util::random_engine_or_default(_re));
 
   std::uniform_int_distribution<> randbool(0, 1);
   std::uniform_int_distribution<> rands(1, _gens.size() - 1);
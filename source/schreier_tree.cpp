@@ -36,9 +36,17 @@ std::vector<unsigned> SchreierTree::nodes() const
   return result;
 }
 
+unsigned SchreierTree::size() const
+{
+  return _edges.size() + 1u;
+}
+
 PermSet SchreierTree::labels() const
 {
-  return _labels;
+  PermSet res(_labels);
+  insert_labels_fixing_orbit(res);
+
+  return res;
 }
 
 bool SchreierTree::contains(unsigned node) const
@@ -1,8 +1,14 @@
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "hash.hpp"
 #include "task_mapping.hpp"
@@ -25,8 +31,10 @@ void TMO::IterationState::advance()
 
   _processed.insert(_hash(current_copy));
 
+  TaskMapping next;
+
   for (auto const &gen : *_generators) {
-    TaskMapping next(current_copy.permuted(gen));
+    current_copy.permuted_into(next, gen);
 
     if (_processed.find(_hash(next)) == _processed.end())
       _unprocessed.insert(next);
@@ -86,24 +94,457 @@ TMO::IterationState::hash_type TMO::IterationState::container_hash_truncated(
   TaskMapping const &mapping)
 { return util::container_hash(mapping.begin(), mapping.end()); }
 
+namespace
+{
+
+using word_type = uint64_t;
+
+constexpr unsigned word_bits = 64u;
+constexpr unsigned index_bits_min = 4u;
+
+unsigned task_bits_required(uint64_t task)
+{
+  unsigned bits = 1u;
+  while (task >> bits)
+    ++bits;
+
+  return bits;
+}
+
+unsigned task_bits_required(TaskMapping const &mapping)
+{
+  unsigned task_max = 0u;
+  for (unsigned task : mapping)
+    task_max = std::max(task_max, task);
+
+  return task_bits_required(task_max);
+}
+
+unsigned mapping_words_required(unsigned mapping_size, unsigned task_bits)
+{
+  unsigned bits = mapping_size * task_bits;
+
+  return std::max(1u, (bits + word_bits - 1u) / word_bits);
+}
+
+unsigned get_task(word_type const *packed, unsigned i, unsigned task_bits)
+{
+  unsigned bit = i * task_bits;
+  unsigned word = bit / word_bits;
+  unsigned offset = bit % word_bits;
+
+  word_type task = packed[word] >> offset;
+  if (offset + task_bits > word_bits)
+    task |= packed[word + 1u] << (word_bits - offset);
+
+  return static_cast<unsigned>(task & ((word_type(1) << task_bits) - 1u));
+}
+
+void set_task(word_type *packed, unsigned i, unsigned task_bits, unsigned task)
+{
+  unsigned bit = i * task_bits;
+  unsigned word = bit / word_bits;
+  unsigned offset = bit % word_bits;
+
+  // packed representations are zero initialized and tasks are only set once
+  packed[word] |= static_cast<word_type>(task) << offset;
+  if (offset + task_bits > word_bits)
+    packed[word + 1u] |= static_cast<word_type>(task) >> (word_bits - offset);
+}
+
+// fingerprints are computed from (unpacked) tasks and thus stay the same when
+// tasks are widened
+uint64_t fingerprint_init(unsigned mapping_size)
+{ return UINT64_C(0x9e3779b97f4a7c15) ^ mapping_size; }
+
+uint64_t fingerprint_step(uint64_t fp, unsigned task)
+{
+  fp = (fp ^ task) * UINT64_C(0x9e3779b97f4a7c15);
+  return fp ^ (fp >> 29);
+}
+
+uint64_t fingerprint_finalize(uint64_t fp)
+{
+  fp ^= fp >> 33;
+  fp *= UINT64_C(0xff51afd7ed558ccd);
+  fp ^= fp >> 33;
+  fp *= UINT64_C(0xc4ceb9fe1a85ec53);
+  fp ^= fp >> 33;
+
+  return fp;
+}
+
+std::size_t index_slot(uint64_t fp, unsigned index_bits)
+{ return static_cast<std::size_t>(fp >> (64u - index_bits)); }
+
+// the filter consists of blocks of eight 32 bit words (i.e. 32 bytes), for
+// every representative a single bit is set in each word of one block, this
+// "split block" layout means that a filter lookup only touches a single cache
+// line, the filter uses eight bits per index slot and thus between 16 and 32
+// bits per representative which results in a false positive rate well below one
+// percent
+constexpr unsigned filter_block_words = 8u;
+
+std::size_t filter_blocks(unsigned index_bits)
+{ return index_bits > 5u ? std::size_t(1) << (index_bits - 5u) : 1u; }
+
+std::size_t filter_block(uint64_t fp, std::size_t filter_words)
+{
+  std::size_t num_blocks = filter_words / filter_block_words;
+
+  return (static_cast<std::size_t>(fp >> 32) & (num_blocks - 1u)) *
+         filter_block_words;
+}
+
+uint32_t filter_mask(uint64_t fp, unsigned i)
+{
+  static constexpr uint32_t salts[filter_block_words] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+  };
+
+  return uint32_t(1) << ((static_cast<uint32_t>(fp) * salts[i]) >> 27);
+}
+
+} // anonymous namespace
+
+constexpr TMORs::index_type TMORs::index_empty;
+
+TMORs::TMORs(std::string const &file)
+: _arena(file)
+{
+  _num_orbits = _arena.num_orbits();
+
+  // the arena might contain the words of a representative whose insertion was
+  // interrupted before the number of orbits was updated, these are discarded
+  if (_num_orbits == 0u) {
+    _arena.truncate(0u);
+    return;
+  }
+
+  _mapping_size = _arena.mapping_size();
+  _task_bits = _arena.task_bits();
+  _mapping_words = mapping_words_required(_mapping_size, _task_bits);
+
+  std::size_t num_words = static_cast<std::size_t>(_num_orbits) * _mapping_words;
+
+  if (_arena.size() < num_words)
+    throw std::runtime_error("corrupted representatives file '" + file + "'");
+
+  if (_arena.size() > num_words)
+    _arena.truncate(num_words);
+
+  unsigned index_bits = index_bits_min;
+  while ((std::size_t(1) << index_bits) < 2u * _num_orbits)
+    ++index_bits;
+
+  index_rebuild(index_bits);
+}
+
+bool TMORs::operator==(TMORs const &rhs) const
+{
+  if (num_orbits() != rhs.num_orbits())
+    return false;
+
+  for (unsigned i = 0u; i < rhs.num_orbits(); ++i) {
+    if (!is_repr(rhs.repr(i)))
+      return false;
+  }
+
+  return true;
+}
+
 std::pair<bool, unsigned> TMORs::insert(TaskMapping const &mapping)
 {
-  bool new_orbit;
-  unsigned equivalence_class;
+  if (_num_orbits == 0u) {
+    _mapping_size = static_cast<unsigned>(mapping.size());
+    _task_bits = task_bits_required(mapping);
+    _mapping_words = mapping_words_required(_mapping_size, _task_bits);
+
+    index_rebuild(index_bits_min);
+
+  } else {
+    if (mapping.size() != _mapping_size)
+      throw std::invalid_argument("orbit representatives must have equal length");
+
+    unsigned task_bits = task_bits_required(mapping);
+    if (task_bits > _task_bits)
+      repack(task_bits);
+  }
+
+  uint64_t fp = fingerprint(mapping);
+
+  if (filter_contains(fp)) {
+    std::size_t slot = index_find(mapping, fp);
+
+    if (_index[slot] != index_empty)
+      return {false, _index[slot]};
+  }
+
+  assert(_num_orbits < index_empty);
 
-  auto it = _orbit_reprs.find(mapping);
-  if (it == _orbit_reprs.end()) {
-    new_orbit = true;
-    equivalence_class = num_orbits();
+  unsigned equivalence_class = _num_orbits;
 
-    _orbit_reprs[mapping] = equivalence_class;
+  std::vector<word_type> packed;
+  pack(mapping, packed);
 
+  _arena.append(packed.data(), packed.data() + packed.size());
+  _arena.commit(_mapping_size, _task_bits, ++_num_orbits);
+
+  // keep the load factor of the index at most one half
+  if (2u * _num_orbits > _index.size()) {
+    index_rebuild(_index_bits + 1u);
   } else {
-    new_orbit = false;
-    equivalence_class = it->second;
+    index_insert(fp, equivalence_class);
+    filter_insert(fp);
   }
 
-  return {new_orbit, equivalence_class};
+  return {true, equivalence_class};
+}
+
+bool TMORs::is_repr(TaskMapping const &mapping) const
+{
+  if (_num_orbits == 0u || mapping.size() != _mapping_size)
+    return false;
+
+  uint64_t fp = fingerprint(mapping);
+
+  if (!filter_contains(fp)) {
+    _filter_counters.misses.fetch_add(1u, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (_index[index_find(mapping, fp)] == index_empty) {
+    _filter_counters.false_positives.fetch_add(1u, std::memory_order_relaxed);
+    return false;
+  }
+
+  _filter_counters.hits.fetch_add(1u, std::memory_order_relaxed);
+  return true;
+}
+
+TaskMapping TMORs::repr(unsigned equivalence_class) const
+{
+  assert(equivalence_class < _num_orbits);
+
+  auto packed(packed_repr(equivalence_class));
+
+  std::vector<unsigned> tasks(_mapping_size);
+  for (unsigned i = 0u; i < _mapping_size; ++i)
+    tasks[i] = get_task(packed, i, _task_bits);
+
+  return TaskMapping(tasks);
+}
+
+TMORs::FilterStats TMORs::filter_stats() const
+{
+  FilterStats stats;
+  stats.hits = _filter_counters.hits.load(std::memory_order_relaxed);
+  stats.misses = _filter_counters.misses.load(std::memory_order_relaxed);
+  stats.false_positives =
+    _filter_counters.false_positives.load(std::memory_order_relaxed);
+
+  return stats;
+}
+
+void TMORs::reset_filter_stats() const
+{ _filter_counters = FilterCounters(); }
+
+void TMORs::pack(TaskMapping const &mapping,
+                 std::vector<word_type> &packed) const
+{
+  packed.assign(_mapping_words, 0u);
+
+  for (unsigned i = 0u; i < _mapping_size; ++i)
+    set_task(packed.data(), i, _task_bits, mapping[i]);
+}
+
+void TMORs::repack(unsigned task_bits)
+{
+  // fingerprints do not depend on the task width so neither the index nor the
+  // filter have to be rebuilt here, representatives are repacked one at a time
+  // so that file backed arenas never have to fit into memory
+  unsigned mapping_words = mapping_words_required(_mapping_size, task_bits);
+
+  auto arena(_arena.replacement());
+
+  std::vector<word_type> repacked;
+
+  for (unsigned j = 0u; j < _num_orbits; ++j) {
+    auto packed(packed_repr(j));
+
+    repacked.assign(mapping_words, 0u);
+
+    for (unsigned i = 0u; i < _mapping_size; ++i)
+      set_task(repacked.data(), i, task_bits, get_task(packed, i, _task_bits));
+
+    arena.append(repacked.data(), repacked.data() + repacked.size());
+  }
+
+  _arena.replace(std::move(arena), _mapping_size, task_bits, _num_orbits);
+
+  _task_bits = task_bits;
+  _mapping_words = mapping_words;
+}
+
+uint64_t TMORs::fingerprint(TaskMapping const &mapping) const
+{
+  uint64_t fp = fingerprint_init(_mapping_size);
+  for (unsigned i = 0u; i < _mapping_size; ++i)
+    fp = fingerprint_step(fp, mapping[i]);
+
+  return fingerprint_finalize(fp);
+}
+
+uint64_t TMORs::fingerprint(word_type const *packed) const
+{
+  uint64_t fp = fingerprint_init(_mapping_size);
+  for (unsigned i = 0u; i < _mapping_size; ++i)
+    fp = fingerprint_step(fp, get_task(packed, i, _task_bits));
+
+  return fingerprint_finalize(fp);
+}
+
+std::size_t TMORs::index_find(TaskMapping const &mapping, uint64_t fp) const
+{
+  // linear probing, terminates since the index is never full
+  std::size_t mask = _index.size() - 1u;
+
+  for (std::size_t slot = index_slot(fp, _index_bits);;
+       slot = (slot + 1u) & mask) {
+
+    index_type equivalence_class = _index[slot];
+
+    if (equivalence_class == index_empty)
+      return slot;
+
+    auto packed(packed_repr(equivalence_class));
+
+    unsigned i = 0u;
+    while (i < _mapping_size && mapping[i] == get_task(packed, i, _task_bits))
+      ++i;
+
+    if (i == _mapping_size)
+      return slot;
+  }
+}
+
+void TMORs::index_insert(uint64_t fp, index_type equivalence_class)
+{
+  std::size_t mask = _index.size() - 1u;
+
+  std::size_t slot = index_slot(fp, _index_bits);
+  while (_index[slot] != index_empty)
+    slot = (slot + 1u) & mask;
+
+  _index[slot] = equivalence_class;
+}
+
+void TMORs::index_rebuild(unsigned index_bits)
+{
+  _index_bits = index_bits;
+  _index.assign(std::size_t(1) << _index_bits, index_empty);
+
+  _filter.assign(filter_blocks(_index_bits) * filter_block_words, 0u);
+
+  for (unsigned j = 0u; j < _num_orbits; ++j) {
+    uint64_t fp = fingerprint(packed_repr(j));
+
+    index_insert(fp, j);
+    filter_insert(fp);
+  }
+}
+
+bool TMORs::filter_contains(uint64_t fp) const
+{
+  auto block(_filter.data() + filter_block(fp, _filter.size()));
+
+  for (unsigned i = 0u; i < filter_block_words; ++i) {
+    if (!(block[i] & filter_mask(fp, i)))
+      return false;
+  }
+
+  return true;
+}
+
+void TMORs::filter_insert(uint64_t fp)
+{
+  auto block(_filter.data() + filter_block(fp, _filter.size()));
+
+  for (unsigned i = 0u; i < filter_block_words; ++i)
+    block[i] |= filter_mask(fp, i);
+}
+
+ConcurrentTMORs::ConcurrentTMORs(unsigned num_shards)
+: _shard_bits(shard_bits(num_shards)),
+  _shards(1u << _shard_bits),
+  _num_orbits(0u),
+  _sequence_next(0u)
+{}
+
+std::pair<bool, unsigned> ConcurrentTMORs::insert(TaskMapping const &mapping)
+{
+  auto &s(_shards[shard_index(mapping)]);
+
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  auto it(s.orbit_reprs.find(mapping));
+  if (it != s.orbit_reprs.end())
+    return {false, it->second};
+
+  unsigned equivalence_class = _num_orbits.fetch_add(1u);
+
+  s.orbit_reprs.emplace(mapping, equivalence_class);
+
+  return {true, equivalence_class};
+}
+
+std::pair<bool, unsigned> ConcurrentTMORs::insert(TaskMapping const &mapping,
+                                                  std::size_t sequence_number)
+{
+  std::unique_lock<std::mutex> lock(_sequence_mutex);
+
+  _sequence_cv.wait(lock, [&]{ return _sequence_next == sequence_number; });
+
+  auto res(insert(mapping));
+
+  ++_sequence_next;
+
+  lock.unlock();
+  _sequence_cv.notify_all();
+
+  return res;
+}
+
+bool ConcurrentTMORs::is_repr(TaskMapping const &mapping) const
+{
+  auto const &s(_shards[shard_index(mapping)]);
+
+  std::lock_guard<std::mutex> lock(s.mutex);
+
+  return s.orbit_reprs.find(mapping) != s.orbit_reprs.end();
+}
+
+unsigned ConcurrentTMORs::shard_bits(unsigned num_shards)
+{
+  unsigned bits = 0u;
+  while ((1u << bits) < num_shards)
+    ++bits;
+
+  return bits;
+}
+
+std::size_t ConcurrentTMORs::shard_index(TaskMapping const &mapping) const
+{
+  if (_shard_bits == 0u)
+    return 0u;
+
+  // the low bits of the hash also determine the bucket inside of a shard,
+  // so the shard is instead selected by the high bits of the scrambled hash
+  uint64_t h = std::hash<TaskMapping>()(mapping);
+  h *= UINT64_C(0x9e3779b97f4a7c15);
+
+  return static_cast<std::size_t>(h >> (64u - _shard_bits));
 }
 
 } // namespace mpsym
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "task_mapping_orbit_arena.hpp"
+
+namespace
+{
+
+constexpr std::size_t file_size_min = 1u << 16;
+
+[[noreturn]] void throw_file_error(std::string const &what,
+                                   std::string const &file)
+{
+  throw std::runtime_error(
+    what + " '" + file + "': " + std::string(std::strerror(errno)));
+}
+
+} // anonymous namespace
+
+namespace mpsym
+{
+
+namespace internal
+{
+
+constexpr uint64_t TMORsArena::file_magic;
+constexpr uint64_t TMORsArena::file_version;
+
+TMORsArena::TMORsArena(std::string const &file)
+{ open(file); }
+
+TMORsArena::TMORsArena(TMORsArena const &other)
+: _header(other._header),
+  _words(other.data(),
+         other.data() + other.size() + other._num_words_uncommitted),
+  _num_words_uncommitted(other._num_words_uncommitted)
+{}
+
+TMORsArena::TMORsArena(TMORsArena &&other) noexcept
+{ swap(other); }
+
+TMORsArena &TMORsArena::operator=(TMORsArena other) noexcept
+{
+  swap(other);
+  return *this;
+}
+
+TMORsArena::~TMORsArena()
+{ close(); }
+
+void TMORsArena::swap(TMORsArena &other) noexcept
+{
+  std::swap(_header, other._header);
+  std::swap(_words, other._words);
+  std::swap(_file, other._file);
+  std::swap(_fd, other._fd);
+  std::swap(_map, other._map);
+  std::swap(_map_size, other._map_size);
+  std::swap(_num_words_uncommitted, other._num_words_uncommitted);
+}
+
+TMORsArena::word_type *TMORsArena::data()
+{
+  if (!file_backed())
+    return _words.data();
+
+  return reinterpret_cast<word_type *>(_map + sizeof(Header));
+}
+
+TMORsArena::word_type const *TMORsArena::data() const
+{
+  if (!file_backed())
+    return _words.data();
+
+  return reinterpret_cast<word_type const *>(_map + sizeof(Header));
+}
+
+void TMORsArena::append(word_type const *first, word_type const *last)
+{
+  auto num_words = static_cast<std::size_t>(last - first);
+
+  if (file_backed()) {
+    std::size_t offset = size() + _num_words_uncommitted;
+
+    reserve(offset + num_words);
+
+    std::copy(first, last, data() + offset);
+
+  } else {
+    _words.insert(_words.end(), first, last);
+  }
+
+  _num_words_uncommitted += num_words;
+}
+
+void TMORsArena::commit(unsigned mapping_size,
+                        unsigned task_bits,
+                        unsigned num_orbits)
+{
+  _header.mapping_size = mapping_size;
+  _header.task_bits = task_bits;
+  _header.num_orbits = num_orbits;
+  _header.num_words += _num_words_uncommitted;
+
+  _num_words_uncommitted = 0u;
+
+  if (!file_backed())
+    return;
+
+  // new representatives only become visible once the number of orbits has been
+  // updated which thus has to happen last, should the process be killed right
+  // before, the additional words are discarded when the file is opened again
+  Header *header = mapped_header();
+
+  header->mapping_size = _header.mapping_size;
+  header->task_bits = _header.task_bits;
+  header->num_words = _header.num_words;
+
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+
+  header->num_orbits = _header.num_orbits;
+}
+
+void TMORsArena::truncate(std::size_t num_words)
+{
+  assert(num_words <= size());
+
+  _header.num_words = num_words;
+
+  _num_words_uncommitted = 0u;
+
+  if (!file_backed()) {
+    _words.resize(num_words);
+    return;
+  }
+
+  mapped_header()->num_words = num_words;
+}
+
+TMORsArena TMORsArena::replacement() const
+{
+  if (!file_backed())
+    return TMORsArena();
+
+  // a temporary file possibly left behind by an earlier crash is stale
+  std::string file_tmp(_file + ".tmp");
+  ::unlink(file_tmp.c_str());
+
+  return TMORsArena(file_tmp);
+}
+
+void TMORsArena::replace(TMORsArena replacement,
+                         unsigned mapping_size,
+                         unsigned task_bits,
+                         unsigned num_orbits)
+{
+  assert(replacement.file_backed() == file_backed());
+
+  replacement.commit(mapping_size, task_bits, num_orbits);
+
+  if (file_backed()) {
+    replacement.sync();
+
+    if (std::rename(replacement._file.c_str(), _file.c_str()) != 0)
+      throw_file_error("failed to replace", _file);
+
+    replacement._file = _file;
+  }
+
+  swap(replacement);
+}
+
+void TMORsArena::sync() const
+{
+  if (!file_backed())
+    return;
+
+  if (::msync(_map, _map_size, MS_SYNC) != 0)
+    throw_file_error("failed to sync", _file);
+}
+
+void TMORsArena::open(std::string const &file)
+{
+  _file = file;
+
+  _fd = ::open(file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (_fd == -1)
+    throw_file_error("failed to open", file);
+
+  try {
+    struct stat st;
+    if (::fstat(_fd, &st) != 0)
+      throw_file_error("failed to stat", file);
+
+    auto file_size = static_cast<std::size_t>(st.st_size);
+
+    if (file_size >= sizeof(Header)) {
+      map(file_size);
+
+      _header = *mapped_header();
+    }
+
+    // a crash might have happened in between creating and initializing the file
+    if (_header.magic == 0u && _header.num_words == 0u) {
+      _header.magic = file_magic;
+      _header.version = file_version;
+
+      reserve(0u);
+
+      *mapped_header() = _header;
+
+    } else {
+      if (_header.magic != file_magic || _header.version != file_version)
+        throw std::runtime_error("not a representatives file '" + file + "'");
+
+      if (sizeof(Header) + _header.num_words * sizeof(word_type) > file_size)
+        throw std::runtime_error("corrupted representatives file '" + file + "'");
+    }
+
+  } catch (...) {
+    _header = Header();
+    close();
+    throw;
+  }
+}
+
+void TMORsArena::close() noexcept
+{
+  if (_map) {
+    ::munmap(_map, _map_size);
+
+    _map = nullptr;
+    _map_size = 0u;
+  }
+
+  if (_fd != -1) {
+    // trimming unused capacity is not essential, errors are thus ignored
+    if (_header.magic == file_magic) {
+      auto file_size = sizeof(Header) + size() * sizeof(word_type);
+      (void)::ftruncate(_fd, static_cast<off_t>(file_size));
+    }
+
+    ::close(_fd);
+
+    _fd = -1;
+  }
+}
+
+void TMORsArena::map(std::size_t file_size)
+{
+  if (_map) {
+    ::munmap(_map, _map_size);
+
+    _map = nullptr;
+    _map_size = 0u;
+  }
+
+  void *map = ::mmap(nullptr,
+                     file_size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED,
+                     _fd,
+                     0);
+
+  if (map == MAP_FAILED)
+    throw_file_error("failed to map", _file);
+
+  _map = static_cast<char *>(map);
+  _map_size = file_size;
+}
+
+void TMORsArena::reserve(std::size_t num_words)
+{
+  std::size_t file_size = sizeof(Header) + num_words * sizeof(word_type);
+
+  if (_map && file_size <= _map_size)
+    return;
+
+  file_size = std::max({file_size, 2u * _map_size, file_size_min});
+
+  if (::ftruncate(_fd, static_cast<off_t>(file_size)) != 0)
+    throw_file_error("failed to resize", _file);
+
+  map(file_size);
+}
+
+} // namespace internal
+
+} // namespace mpsym
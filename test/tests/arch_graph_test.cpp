@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -8,6 +10,7 @@
 #include "gmock/gmock.h"
 
 #include "arch_graph.hpp"
+#include "arch_graph_automorphisms.hpp"
 #include "arch_graph_cluster.hpp"
 #include "arch_graph_system.hpp"
 #include "arch_uniform_super_graph.hpp"
@@ -318,6 +321,29 @@ TEST_F(ArchGraphTest, CanObtainAutomorphisms)
     << "Automorphisms of minimal triangular architecture graph correct.";
 }
 
+TEST_F(ArchGraphTest, CanObtainNumberOfAutomorphisms)
+{
+  std::vector<std::pair<ArchGraph, unsigned>> ags {
+    {ag_nocol(), 8u},
+    {ag_vcol(), 4u},
+    {ag_ecol(), 4u},
+    {ag_tcol(), 2u},
+    {ag_tri(), 6u},
+    {ag_grid33(), 8u}
+  };
+
+  for (auto &ag : ags) {
+    EXPECT_EQ(ag.second, ag.first.num_automorphisms())
+      << "Number of automorphisms correct without constructing automorphisms.";
+
+    EXPECT_FALSE(ag.first.automorphisms_ready())
+      << "Determining number of automorphisms does not construct automorphisms.";
+
+    EXPECT_EQ(ag.first.automorphisms().order(), ag.first.num_automorphisms())
+      << "Number of automorphisms consistent with automorphisms.";
+  }
+}
+
 class ArchGraphReprVariantTest :
   public ArchGraphTestBase<testing::TestWithParam<ReprOptions::Method>>
 {};
@@ -372,7 +398,8 @@ INSTANTIATE_TEST_SUITE_P(
   ArchGraphReprVariantTest,
   testing::Values(ReprOptions::Method::ITERATE,
                   ReprOptions::Method::LOCAL_SEARCH,
-                  ReprOptions::Method::ORBITS));
+                  ReprOptions::Method::ORBITS,
+                  ReprOptions::Method::CANONICAL));
 
 template<typename T>
 class ArchGraphClusterTestBase : public T
@@ -440,6 +467,50 @@ TEST_F(ArchGraphClusterTest, CanObtainAutormorphisms)
     << "Automorphisms of minimal architecture graph cluster correct.";
 }
 
+TEST(ArchGraphClusterExtendTest, CanExtendAutomorphisms)
+{
+  std::vector<std::shared_ptr<ArchGraphSystem>> subsystems {
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::dihedral(8)),
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup(1)),
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::symmetric(3)),
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup(2)),
+    std::make_shared<ArchGraphAutomorphisms>(PermGroup::cyclic(5))
+  };
+
+  for (auto const &subsystem : subsystems)
+    subsystem->automorphisms();
+
+  ArchGraphCluster cluster;
+
+  for (auto i = 0u; i < subsystems.size(); ++i) {
+    // automorphisms are already known here (except before the first subsystem
+    // is added) so that they are extended instead of being recomputed
+    if (i > 0u) {
+      cluster.automorphisms();
+      cluster.num_automorphisms();
+    }
+
+    cluster.add_subsystem(subsystems[i]);
+
+    ArchGraphCluster cluster_scratch;
+    for (auto j = 0u; j <= i; ++j)
+      cluster_scratch.add_subsystem(subsystems[j]);
+
+    auto automorphisms(cluster.automorphisms());
+    auto automorphisms_scratch(cluster_scratch.automorphisms());
+
+    ASSERT_EQ(automorphisms_scratch.degree(), automorphisms.degree())
+      << "Degree of extended automorphism group correct.";
+
+    EXPECT_TRUE(automorphisms == automorphisms_scratch &&
+                automorphisms_scratch == automorphisms)
+      << "Extended automorphism group correct.";
+
+    EXPECT_EQ(cluster_scratch.num_automorphisms(), cluster.num_automorphisms())
+      << "Order of extended automorphism group correct.";
+  }
+}
+
 class ArchGraphClusterReprVariantTest :
   public ArchGraphClusterTestBase<testing::TestWithParam<ReprOptions::Method>>
 {};
@@ -468,7 +539,236 @@ INSTANTIATE_TEST_SUITE_P(
   ArchGraphClusterReprVariantTest,
   testing::Values(ReprOptions::Method::ITERATE,
                   ReprOptions::Method::LOCAL_SEARCH,
-                  ReprOptions::Method::ORBITS));
+                  ReprOptions::Method::ORBITS,
+                  ReprOptions::Method::CANONICAL));
+
+TEST_F(ArchGraphClusterTest, CanDecomposeFlatAutomorphisms)
+{
+  ArchGraphAutomorphisms flat(cluster_minimal->automorphisms());
+
+  for (auto decomposition : {ReprOptions::Decomposition::DISJOINT,
+                             ReprOptions::Decomposition::AUTO}) {
+    ReprOptions options;
+    options.decomposition = decomposition;
+
+    for (auto i = 0u; i < cluster_minimal->num_processors(); ++i) {
+      for (auto j = 0u; j < cluster_minimal->num_processors(); ++j) {
+        TaskMapping mapping({i, j});
+
+        EXPECT_EQ(cluster_minimal->repr(mapping),
+                  flat.repr(mapping, &options))
+          << "Representative determined correctly via disjoint decomposition.";
+      }
+    }
+  }
+}
+
+TEST(ArchGraphAutomorphismsTest, CanDetermineReprViaDecomposition)
+{
+  std::vector<PermGroup> automorphisms {
+    // relabelled C3 wr S3 (for which the heuristic block permuter image is
+    // not contained in the group)
+    PermGroup(9, {Perm(9, {{0, 4, 7}}),
+                  Perm(9, {{1, 2, 5}}),
+                  Perm(9, {{1, 6}, {2, 3}, {5, 8}}),
+                  Perm(9, {{3, 8, 6}}),
+                  Perm(9, {{0, 3}, {4, 8}, {6, 7}})}),
+    // relabelled S2 wr C4
+    PermGroup(8, {Perm(8, {{3, 6}}),
+                  Perm(8, {{3, 0, 5, 2}, {6, 7, 1, 4}})}),
+    // intransitive
+    PermGroup(PermGroup::wreath_product(PermGroup::dihedral(4),
+                                        PermGroup::cyclic(3)).generators())
+  };
+
+  ReprOptions options_iterate;
+  options_iterate.method = ReprOptions::Method::ITERATE;
+
+  for (auto const &automorphisms_ : automorphisms) {
+    ArchGraphAutomorphisms ag(automorphisms_);
+
+    unsigned n = automorphisms_.degree();
+
+    std::vector<TaskMapping> mappings {
+      TaskMapping({8u % n, 2u, 0u, 7u, 8u % n}),
+      TaskMapping({4u, 2u, 9u % n})
+    };
+
+    for (unsigned i = 0u; i < n; ++i) {
+      for (unsigned j = 0u; j < n; ++j) {
+        for (unsigned k = 0u; k < n; ++k)
+          mappings.push_back(TaskMapping({i, j, k}));
+      }
+    }
+
+    for (auto decomposition : {ReprOptions::Decomposition::WREATH,
+                               ReprOptions::Decomposition::AUTO}) {
+      ReprOptions options;
+      options.method = ReprOptions::Method::ITERATE;
+      options.decomposition = decomposition;
+
+      for (auto const &mapping : mappings) {
+        EXPECT_EQ(ag.repr(mapping, &options_iterate), ag.repr(mapping, &options))
+          << "Representative determined correctly via decomposition.";
+      }
+    }
+  }
+}
+
+TEST(ArchGraphAutomorphismsTest, CanDetermineReprOfDirectProduct)
+{
+  // the strong generating sets of these factors are not closed under inversion
+  std::vector<PermGroup> factors {
+    PermGroup(5, {Perm(5, {{0, 1, 2, 3, 4}})}),
+    PermGroup(4, {Perm(4, {{0, 1, 2, 3}})})
+  };
+
+  auto automorphisms(PermGroup::direct_product(factors.begin(), factors.end()));
+
+  ArchGraphAutomorphisms ag(automorphisms);
+  ArchGraphAutomorphisms ag_expected(
+    PermGroup(automorphisms.degree(), automorphisms.generators()));
+
+  for (auto method : {ReprOptions::Method::ITERATE,
+                      ReprOptions::Method::CANONICAL}) {
+    ReprOptions options;
+    options.method = method;
+    options.decomposition = ReprOptions::Decomposition::NONE;
+
+    unsigned n = automorphisms.degree();
+
+    for (unsigned i = 0u; i < n; ++i) {
+      for (unsigned j = 0u; j < n; ++j) {
+        TaskMapping mapping({i, j});
+
+        EXPECT_EQ(ag_expected.repr(mapping, &options), ag.repr(mapping, &options))
+          << "Representative of direct product determined correctly.";
+      }
+    }
+  }
+}
+
+TEST(ArchGraphAutomorphismsTest, CanDetermineCanonicalRepr)
+{
+  auto automorphisms(PermGroup::wreath_product(PermGroup::symmetric(2),
+                                               PermGroup::cyclic(4)));
+
+  ArchGraphAutomorphisms ag(automorphisms);
+
+  ReprOptions options_iterate;
+  options_iterate.method = ReprOptions::Method::ITERATE;
+
+  ReprOptions options_canonical;
+  options_canonical.method = ReprOptions::Method::CANONICAL;
+
+  unsigned n = automorphisms.degree();
+
+  for (unsigned i = 0u; i < n; ++i) {
+    for (unsigned j = 0u; j < n; ++j) {
+      for (unsigned k = 0u; k < n; ++k) {
+        TaskMapping mapping({i, j, k});
+
+        EXPECT_EQ(ag.repr(mapping, &options_iterate),
+                  ag.repr(mapping, &options_canonical))
+          << "Canonical representative equal to minimal orbit element.";
+      }
+    }
+  }
+}
+
+TEST(ArchGraphAutomorphismsTest, CanDetermineReprConcurrently)
+{
+  auto automorphisms(PermGroup::wreath_product(PermGroup::symmetric(2),
+                                               PermGroup::cyclic(4)));
+
+  unsigned n = automorphisms.degree();
+
+  std::vector<TaskMapping> mappings;
+  for (unsigned i = 0u; i < n; ++i) {
+    for (unsigned j = 0u; j < n; ++j)
+      mappings.emplace_back(TaskMapping({j, i}));
+  }
+
+  for (auto decomposition : {ReprOptions::Decomposition::NONE,
+                             ReprOptions::Decomposition::AUTO}) {
+    ReprOptions options;
+    options.decomposition = decomposition;
+
+    ArchGraphAutomorphisms ag_serial(automorphisms);
+
+    std::vector<TaskMapping> reprs_serial;
+    for (auto const &mapping : mappings)
+      reprs_serial.push_back(ag_serial.repr(mapping, &options));
+
+    // lazy initialization is triggered by all threads at once
+    ArchGraphAutomorphisms const ag(automorphisms);
+
+    std::vector<std::vector<TaskMapping>> reprs(4);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0u; t < reprs.size(); ++t) {
+      threads.emplace_back([&, t]{
+        for (auto const &mapping : mappings)
+          reprs[t].push_back(ag.repr(mapping, &options));
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    for (auto const &reprs_thread : reprs) {
+      EXPECT_EQ(reprs_serial, reprs_thread)
+        << "Concurrently determined representatives equal to serially determined ones.";
+    }
+  }
+}
+
+TEST(ArchGraphAutomorphismsTest, CanDetermineReprBatch)
+{
+  auto automorphisms(PermGroup::wreath_product(PermGroup::symmetric(2),
+                                               PermGroup::cyclic(4)));
+
+  unsigned n = automorphisms.degree();
+
+  std::vector<TaskMapping> mappings;
+  for (unsigned i = 0u; i < n; ++i) {
+    for (unsigned j = 0u; j < n; ++j) {
+      for (unsigned k = 0u; k < n; ++k)
+        mappings.emplace_back(TaskMapping({k, j, i}));
+    }
+  }
+
+  for (auto method : {ReprOptions::Method::ITERATE,
+                      ReprOptions::Method::ORBITS,
+                      ReprOptions::Method::CANONICAL}) {
+    ReprOptions options;
+    options.method = method;
+
+    ArchGraphAutomorphisms ag_serial(automorphisms);
+
+    TMORs orbits_serial;
+
+    std::vector<std::tuple<TaskMapping, bool, unsigned>> reprs_serial;
+    for (auto const &mapping : mappings)
+      reprs_serial.push_back(ag_serial.repr(mapping, orbits_serial, &options));
+
+    for (unsigned num_threads : {1u, 2u, 4u}) {
+      ArchGraphAutomorphisms ag(automorphisms);
+
+      TMORs orbits;
+
+      auto reprs(ag.repr_batch(mappings, orbits, &options, num_threads));
+
+      EXPECT_EQ(reprs_serial, reprs)
+        << "Batched representatives equal to serially determined ones"
+        << " (" << num_threads << " threads).";
+
+      EXPECT_EQ(orbits_serial, orbits)
+        << "Batched orbit representatives equal to serially determined ones"
+        << " (" << num_threads << " threads).";
+    }
+  }
+}
 
 template<typename T>
 class ArchUniformSuperGraphTestBase : public T
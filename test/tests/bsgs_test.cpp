@@ -1,9 +1,13 @@
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 
 #include "bsgs.hpp"
+#include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
@@ -13,30 +17,33 @@
 using namespace mpsym;
 using namespace mpsym::internal;
 
-TEST(DISABLED_BSGSSolveTest, CanSolveBSGS)
+TEST(BSGSSolveTest, CanSolveBSGS)
 {
   BSGSOptions bsgs_options;
   bsgs_options.construction = BSGSOptions::Construction::SOLVE;
 
   PermSet generators_solvable {
-    Perm(4, {{2, 4}}),
-    Perm(4, {{1, 2}, {3, 4}})
+    Perm(4, {{1, 3}}),
+    Perm(4, {{0, 1}, {2, 3}})
   };
 
   Perm generators_solvable_expected_elements[] = {
-    Perm(4, {{1, 2, 3, 4}}),
-    Perm(4, {{1, 2}, {3, 4}}),
-    Perm(4, {{1, 3}, {2, 4}}),
-    Perm(4, {{1, 3}}),
-    Perm(4, {{1, 4, 3, 2}}),
-    Perm(4, {{1, 4}, {2, 3}}),
-    Perm(4, {{2, 4}})
+    Perm(4, {{0, 1, 2, 3}}),
+    Perm(4, {{0, 1}, {2, 3}}),
+    Perm(4, {{0, 2}, {1, 3}}),
+    Perm(4, {{0, 2}}),
+    Perm(4, {{0, 3, 2, 1}}),
+    Perm(4, {{0, 3}, {1, 2}}),
+    Perm(4, {{1, 3}})
   };
 
   PermSet generators_non_solvable(PermGroup::symmetric(5).generators());
 
   BSGS bsgs(4, generators_solvable, &bsgs_options);
 
+  EXPECT_EQ(8, bsgs.order())
+    << "Solvable group BSGS has correct order.";
+
   for (Perm const &perm : generators_solvable_expected_elements) {
     EXPECT_TRUE(bsgs.strips_completely(perm))
       << "Solvable group BSGS correct.";
@@ -47,6 +54,126 @@ TEST(DISABLED_BSGSSolveTest, CanSolveBSGS)
       << "Solving BSGS fails for non-solvable group generating set.";
 }
 
+TEST(BSGSSolveTest, CanSolveTorusAutomorphismsBSGS)
+{
+  unsigned const n = 4u;
+
+  auto torus_perm = [&](std::function<std::pair<unsigned, unsigned>(unsigned, unsigned)> f) {
+    std::vector<unsigned> perm(n * n);
+    for (unsigned x = 0u; x < n; ++x) {
+      for (unsigned y = 0u; y < n; ++y) {
+        auto xy(f(x, y));
+        perm[x * n + y] = xy.first * n + xy.second;
+      }
+    }
+
+    return Perm(perm);
+  };
+
+  PermSet generators {
+    torus_perm([&](unsigned x, unsigned y){ return std::make_pair((x + 1u) % n, y); }),
+    torus_perm([&](unsigned x, unsigned y){ return std::make_pair(x, (y + 1u) % n); }),
+    torus_perm([&](unsigned x, unsigned y){ return std::make_pair((n - x) % n, y); }),
+    torus_perm([&](unsigned x, unsigned y){ return std::make_pair(y, x); })
+  };
+
+  BSGSOptions bsgs_options;
+  bsgs_options.construction = BSGSOptions::Construction::SOLVE;
+
+  BSGS bsgs_solved(n * n, generators, &bsgs_options);
+  BSGS bsgs_expected(n * n, generators);
+
+  ASSERT_EQ(bsgs_expected.order(), bsgs_solved.order())
+    << "Solved BSGS has correct order.";
+
+  for (Perm const &gen : generators) {
+    EXPECT_TRUE(bsgs_solved.strips_completely(gen))
+      << "Solved BSGS contains generators.";
+  }
+
+  for (Perm const &sg : bsgs_expected.strong_generators()) {
+    EXPECT_TRUE(bsgs_solved.strips_completely(sg))
+      << "Solved BSGS contains all group elements.";
+  }
+}
+
+TEST(BSGSReduceGensTest, CanReduceStrongGenerators)
+{
+  std::vector<PermSet> generators {
+    {
+      Perm(8, {{0, 1, 2, 3}}),
+      Perm(8, {{0, 2}}),
+      Perm(8, {{4, 5, 6}, {0, 1}}),
+      Perm(8, {{6, 7}})
+    },
+    {
+      Perm(8, {{0, 1}}),
+      Perm(8, {{0, 2, 4, 6}, {1, 3, 5, 7}}),
+      Perm(8, {{0, 4}, {1, 5}}),
+      Perm(8, {{2, 3}, {6, 7}})
+    },
+    {
+      Perm(9, {{0, 1, 2}}),
+      Perm(9, {{0, 1, 2}, {3, 4, 5}}),
+      Perm(9, {{0, 3, 6}, {1, 4, 7}, {2, 5, 8}}),
+      Perm(9, {{3, 4, 5}, {6, 7, 8}}),
+      Perm(9, {{6, 7, 8}})
+    }
+  };
+
+  BSGSOptions bsgs_options;
+  bsgs_options.construction = BSGSOptions::Construction::SCHREIER_SIMS;
+  bsgs_options.check_sym = false;
+
+  BSGSOptions bsgs_options_unreduced(bsgs_options);
+  bsgs_options_unreduced.reduce_gens = false;
+
+  for (auto const &gens : generators) {
+    BSGS bsgs(gens.degree(), gens, &bsgs_options);
+    BSGS bsgs_unreduced(gens.degree(), gens, &bsgs_options_unreduced);
+
+    EXPECT_EQ(bsgs_unreduced.order(), bsgs.order())
+      << "Group order unchanged by strong generator reduction.";
+
+    auto sgs(bsgs.strong_generators());
+    auto sgs_unreduced(bsgs_unreduced.strong_generators());
+
+    EXPECT_LE(sgs.size(), sgs_unreduced.size())
+      << "Strong generator reduction does not add strong generators.";
+
+    for (Perm const &sg : sgs) {
+      EXPECT_TRUE(std::find(sgs_unreduced.begin(), sgs_unreduced.end(), sg)
+                  != sgs_unreduced.end())
+        << "Strong generator reduction only retains strong generators.";
+    }
+
+    // the strong generators fixing the first i base points must still
+    // generate the i-th stabilizer in the stabilizer chain
+    BSGS::order_type stabilizer_order = 1;
+
+    for (unsigned i = bsgs.base_size(); i-- > 0u;) {
+      stabilizer_order *= bsgs.orbit(i).size();
+
+      auto sgs_i(bsgs.strong_generators(i));
+
+      ASSERT_FALSE(sgs_i.empty())
+        << "Strong generators retained for every stabilizer chain level.";
+
+      EXPECT_EQ(stabilizer_order,
+                BSGS(gens.degree(), sgs_i, &bsgs_options_unreduced).order())
+        << "Reduced strong generators generate stabilizer chain level "
+        << i << ".";
+    }
+
+    BSGS bsgs_again(gens.degree(), gens, &bsgs_options);
+
+    EXPECT_TRUE(std::equal(sgs.begin(), sgs.end(),
+                           bsgs_again.strong_generators().begin()) &&
+                sgs.size() == bsgs_again.strong_generators().size())
+      << "Strong generator reduction is deterministic.";
+  }
+}
+
 //TEST(BSGSBaseSwapTest, CanConjugateBSGS)
 //{
 //  PermGroup pg(5, {Perm(5, {{1, 2}, {3, 4}}), Perm(5, {{1, 4, 2}})});
@@ -59,3 +186,77 @@ TEST(DISABLED_BSGSSolveTest, CanSolveBSGS)
 //      << "Permutation group remains the same after conjugating BSGS."
 //  }
 //}
+
+class BSGSBaseChangeTest : public testing::TestWithParam<bool> {};
+
+TEST_P(BSGSBaseChangeTest, CanChangeBase)
+{
+  BSGSOptions bsgs_options;
+  bsgs_options.base_change_randomized = GetParam();
+
+  PermGroup pg(8,
+    {
+      Perm(8, {{0, 1, 2, 3}}),
+      Perm(8, {{0, 2}}),
+      Perm(8, {{4, 5, 6}, {0, 1}}),
+      Perm(8, {{6, 7}})
+    }
+  );
+
+  // direct products whose levels carry the strong generators of the following
+  // factors as additional labels
+  std::vector<std::vector<BSGS>> direct_product_factors {
+    {BSGS(5, {Perm(5, {{0, 1, 2, 3, 4}})}), BSGS(3, {Perm(3, {{0, 1, 2}})})},
+    {BSGS(3, {Perm(3, {{0, 1, 2}})}),
+     BSGS(2, {Perm(2, {{0, 1}})}),
+     BSGS(3, {Perm(3, {{0, 1}}), Perm(3, {{0, 1, 2}})})}
+  };
+
+  std::vector<std::vector<unsigned>> prefixes {
+    {7}, {3, 5}, {6, 2, 0}, {1, 4, 7, 3}
+  };
+
+  auto expect_base_changed = [](PermGroup const &pg,
+                                BSGS const &bsgs,
+                                std::vector<unsigned> const &prefix)
+  {
+    EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), bsgs.base().begin()))
+      << "Base prefix changed correctly.";
+
+    EXPECT_EQ(pg.order(), bsgs.order())
+      << "Group order unchanged by base change.";
+
+    for (Perm const &perm : pg) {
+      if (!bsgs.strips_completely(perm)) {
+        ADD_FAILURE() << "Group elements still contained after base change.";
+        break;
+      }
+    }
+  };
+
+  for (auto const &factors : direct_product_factors) {
+    auto direct_product(BSGS::direct_product(factors));
+
+    PermGroup pg_direct_product(direct_product.degree(),
+                                direct_product.strong_generators());
+
+    for (auto const &prefix : prefixes) {
+      BSGS bsgs(BSGS::direct_product(factors));
+
+      bsgs.base_change(prefix, &bsgs_options);
+
+      expect_base_changed(pg_direct_product, bsgs, prefix);
+    }
+  }
+
+  for (auto const &prefix : prefixes) {
+    BSGS bsgs(pg.degree(), pg.generators());
+
+    bsgs.base_change(prefix, &bsgs_options);
+
+    expect_base_changed(pg, bsgs, prefix);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(BSGSBaseChangeVariants, BSGSBaseChangeTest,
+                         testing::Values(false, true));
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -7,6 +8,7 @@
 #include "gmock/gmock.h"
 
 #include "bsgs.hpp"
+#include "orbit.hpp"
 #include "perm.hpp"
 #include "perm_group.hpp"
 #include "perm_set.hpp"
@@ -81,6 +83,59 @@ TEST(PermGroupTest, CanObtainOrder)
   }
 }
 
+TEST(PermGroupTest, CanConstructWellKnownGroupsExplicitly)
+{
+  // groups are compared via their orders and by checking that each group
+  // contains the other group's generators, enumerating all elements would be
+  // too slow for the larger degrees
+  for (unsigned i = 2u; i <= 8u; ++i) {
+    std::vector<unsigned> cycle(i);
+    std::iota(cycle.begin(), cycle.end(), 0u);
+
+    PermGroup symmetric_expected(i, {Perm(i, {{0, 1}}), Perm(i, {cycle})});
+    PermGroup symmetric_actual(PermGroup::symmetric(i));
+
+    EXPECT_TRUE(symmetric_expected == symmetric_actual &&
+                symmetric_actual == symmetric_expected)
+      << "Symmetric group S" << i << " constructed correctly.";
+
+    PermSet alternating_generators {Perm(i)};
+    for (unsigned j = 2u; j < i; ++j)
+      alternating_generators.insert(Perm(i, {{0, 1, j}}));
+
+    PermGroup alternating_expected(i, alternating_generators);
+    PermGroup alternating_actual(PermGroup::alternating(i));
+
+    EXPECT_EQ(i < 3u ? 1u : util::factorial(i) / 2u,
+              alternating_actual.order())
+      << "Order set correctly for alternating group A" << i;
+
+    EXPECT_TRUE(alternating_expected == alternating_actual &&
+                alternating_actual == alternating_expected)
+      << "Alternating group A" << i << " constructed correctly.";
+
+    PermGroup cyclic_expected(i, {Perm(i, {cycle})});
+    PermGroup cyclic_actual(PermGroup::cyclic(i));
+
+    EXPECT_TRUE(cyclic_expected == cyclic_actual &&
+                cyclic_actual == cyclic_expected)
+      << "Cyclic group Z" << i << " constructed correctly.";
+
+    if (i >= 3u) {
+      std::vector<unsigned> reflection(i);
+      for (unsigned j = 0u; j < i; ++j)
+        reflection[j] = (i - j) % i;
+
+      PermGroup dihedral_expected(i, {Perm(i, {cycle}), Perm(reflection)});
+      PermGroup dihedral_actual(PermGroup::dihedral(2u * i));
+
+      EXPECT_TRUE(dihedral_expected == dihedral_actual &&
+                  dihedral_actual == dihedral_expected)
+        << "Dihedral group D" << 2u * i << " constructed correctly.";
+    }
+  }
+}
+
 TEST(PermGroupTest, CanCheckForSymmetricGroup)
 {
   for (unsigned i = 1u; i < 10; ++i) {
@@ -165,6 +220,126 @@ TEST(PermGroupTest, CanTestMembership)
   }
 }
 
+TEST(PermGroupTest, CanTestMembershipBatched)
+{
+  PermGroup pg(
+    {
+      Perm(8, {{0, 1, 2, 3}, {4, 5, 6, 7}}),
+      Perm(8, {{0, 4}, {1, 5}}),
+      Perm(8, {{1, 3}, {5, 7}})
+    }
+  );
+
+  PermGroup s8(PermGroup::symmetric(8));
+
+  std::vector<Perm> perms;
+  std::vector<bool> expected;
+
+  for (unsigned i = 0u; i < 200u; ++i) {
+    Perm perm(i % 2u == 0u ? pg.random_element() : s8.random_element());
+
+    perms.push_back(perm);
+    expected.push_back(pg.contains_element(perm));
+  }
+
+  EXPECT_EQ(expected, pg.contains_elements(perms))
+    << "Batched membership test agrees with individual membership tests.";
+
+  EXPECT_EQ(expected, pg.contains_elements(perms, 4u))
+    << "Multithreaded batched membership test agrees with individual "
+    << "membership tests.";
+}
+
+TEST(PermGroupTest, CanRejectNonMembersFixingBase)
+{
+  PermGroup pg(6, {Perm(6, {{0, 1}, {2, 3}}), Perm(6, {{0, 1}, {4, 5}})});
+
+  EXPECT_TRUE(pg.contains_element(Perm(6, {{2, 3}, {4, 5}})))
+    << "Membership test correctly identifies group member.";
+
+  EXPECT_FALSE(pg.contains_element(Perm(6, {{0, 1}})))
+    << "Membership test correctly rejects non group member.";
+
+  EXPECT_FALSE(pg.contains_element(Perm(6, {{2, 3}})))
+    << "Membership test correctly rejects non group member.";
+}
+
+class PermGroupClosureTest : public testing::TestWithParam<
+  BSGSOptions::Transversals> {};
+
+TEST_P(PermGroupClosureTest, CanConstructClosure)
+{
+  BSGSOptions bsgs_options;
+  bsgs_options.transversals = GetParam();
+
+  PermGroup pg(BSGS({Perm(6, {{0, 1, 2}})}, &bsgs_options));
+
+  auto pg_closure(pg.closure({Perm(6, {{0, 1}}), Perm(6, {{3, 4, 5}})},
+                             &bsgs_options));
+
+  EXPECT_EQ(3u, pg.order())
+    << "Closure does not modify original permutation group.";
+
+  EXPECT_TRUE(perm_group_equal(
+    PermGroup(6, {Perm(6, {{0, 1, 2}}),
+                  Perm(6, {{0, 1}}),
+                  Perm(6, {{3, 4, 5}})}),
+    pg_closure))
+      << "Closure of permutation group correct.";
+
+  EXPECT_EQ(pg_closure.order(), pg_closure.closure({Perm(6, {{0, 2}})}).order())
+    << "Closure with contained element leaves permutation group unchanged.";
+
+  auto pg_closure_extended(pg_closure.closure({Perm(8, {{6, 7}})},
+                                              &bsgs_options));
+
+  EXPECT_EQ(8u, pg_closure_extended.degree())
+    << "Closure can extend permutation group degree.";
+
+  EXPECT_TRUE(perm_group_equal(
+    PermGroup(8, {Perm(8, {{0, 1, 2}}),
+                  Perm(8, {{0, 1}}),
+                  Perm(8, {{3, 4, 5}}),
+                  Perm(8, {{6, 7}})}),
+    pg_closure_extended))
+      << "Closure of permutation group with extended degree correct.";
+}
+
+TEST(PermGroupTest, CanConstructClosureOfWellKnownGroups)
+{
+  for (auto const &generators : std::vector<PermSet>{{Perm(5, {{0, 1}})},
+                                                     {Perm(5)}}) {
+    auto symmetric_closure(PermGroup::symmetric(4).closure(generators));
+
+    EXPECT_EQ(5u, symmetric_closure.degree())
+      << "Closure of symmetric group has extended degree.";
+
+    EXPECT_EQ(24u, symmetric_closure.order())
+      << "Closure of symmetric group has correct order.";
+
+    EXPECT_FALSE(symmetric_closure.is_symmetric())
+      << "Closure of symmetric group with extended degree not symmetric.";
+
+    auto alternating_closure(PermGroup::alternating(4).closure(generators));
+
+    EXPECT_FALSE(alternating_closure.bsgs().is_alternating())
+      << "Closure of alternating group with extended degree not alternating.";
+  }
+
+  auto alternating_closure(
+    PermGroup::alternating(4).closure({Perm(4, {{0, 1}})}));
+
+  EXPECT_TRUE(alternating_closure.is_symmetric())
+    << "Closure of alternating group with odd permutation symmetric.";
+
+  EXPECT_FALSE(alternating_closure.bsgs().is_alternating())
+    << "Closure of alternating group with odd permutation not alternating.";
+}
+
+INSTANTIATE_TEST_SUITE_P(Transversals, PermGroupClosureTest,
+  testing::Values(BSGSOptions::Transversals::EXPLICIT,
+                  BSGSOptions::Transversals::SCHREIER_TREES));
+
 TEST(PermGroupTest, CanGenerateRandomElement)
 {
   PermGroup a4(verified_perm_group(A4));
@@ -175,6 +350,60 @@ TEST(PermGroupTest, CanGenerateRandomElement)
   }
 }
 
+TEST(PermGroupTest, CanGenerateReproducibleRandomElement)
+{
+  PermGroup s6(PermGroup::symmetric(6));
+
+  auto re1(util::random_engine(42u));
+  auto re2(util::random_engine(42u));
+
+  for (unsigned i = 0u; i < 100u; ++i) {
+    EXPECT_EQ(s6.random_element(&re1), s6.random_element(&re2))
+      << "Equally seeded engines produce equal random group elements.";
+  }
+}
+
+TEST(PermGroupTest, CanCacheBaseChangedBSGSs)
+{
+  PermGroup pg(8,
+    {
+      Perm(8, {{0, 1, 2, 3}}),
+      Perm(8, {{0, 2}}),
+      Perm(8, {{4, 5, 6}, {0, 1}}),
+      Perm(8, {{6, 7}})
+    }
+  );
+
+  // non-const access to the group's BSGS invalidates the cache
+  PermGroup const &pg_const(pg);
+
+  auto base(pg_const.bsgs().base());
+
+  std::vector<std::vector<unsigned>> prefixes {{7}, {3, 5}, {6, 2, 0}};
+
+  std::vector<std::shared_ptr<BSGS const>> bsgss;
+
+  for (auto const &prefix : prefixes) {
+    auto bsgs(pg_const.bsgs(prefix));
+
+    EXPECT_TRUE(bsgs->has_base_prefix(prefix))
+      << "Base prefix changed correctly.";
+
+    EXPECT_EQ(pg.order(), bsgs->order())
+      << "Group order unchanged by base change.";
+
+    bsgss.push_back(bsgs);
+  }
+
+  EXPECT_EQ(base, pg_const.bsgs().base())
+    << "Base changes do not affect the group's own BSGS.";
+
+  for (auto i = 0u; i < prefixes.size(); ++i) {
+    EXPECT_EQ(bsgss[i], pg_const.bsgs(prefixes[i]))
+      << "Base changed BSGS is retrieved from cache.";
+  }
+}
+
 TEST(PermGroupTest, CanIterateTrivialGroup)
 {
   PermGroup id = PermGroup(4, {});
@@ -273,6 +502,41 @@ TEST(PermGroupTest, CanIterateElements)
     << "Iteration produces every element exactly once (explicit iterator).";
 }
 
+TEST(PermGroupTest, CanSkipIteratorLevels)
+{
+  PermGroup pg(PermGroup::wreath_product(PermGroup::symmetric(3),
+                                         PermGroup::cyclic(3)));
+
+  auto const &bsgs(pg.bsgs());
+
+  for (unsigned level = 0u; level < bsgs.base_size(); ++level) {
+    std::vector<std::vector<unsigned>> base_images;
+
+    for (auto it = pg.begin(); it != pg.end(); it.skip(level)) {
+      std::vector<unsigned> base_image;
+      for (unsigned i = 0u; i <= level; ++i)
+        base_image.push_back((*it)[bsgs.base_point(i)]);
+
+      base_images.push_back(base_image);
+    }
+
+    unsigned expected_num_elements = 1u;
+    for (unsigned i = 0u; i <= level; ++i)
+      expected_num_elements *= bsgs.orbit(i).size();
+
+    EXPECT_EQ(expected_num_elements, base_images.size())
+      << "Skipping iterator levels visits one element per partial base image "
+      << "(level " << level << ").";
+
+    std::sort(base_images.begin(), base_images.end());
+
+    EXPECT_TRUE(std::adjacent_find(base_images.begin(), base_images.end())
+                == base_images.end())
+      << "Skipping iterator levels visits distinct partial base images "
+      << "(level " << level << ").";
+  }
+}
+
 class PermGroupConstructionMethodTest : public testing::TestWithParam<
   std::tuple<BSGSOptions::Construction, BSGSOptions::Transversals>> {};
 
@@ -371,6 +635,51 @@ INSTANTIATE_TEST_SUITE_P(ConstructionMethods, PermGroupConstructionMethodTest,
                     BSGSOptions::Transversals::SCHREIER_TREES)));
                     // TODO: SHALLOW_SCHREIER_TREES
 
+TEST(PermGroupConstructionTest, CanPruneSchreierGenerators)
+{
+  PermSet generators[] = {
+    {
+      Perm(9, {{0, 1}}),
+      Perm(9, {{1, 2}}),
+      Perm(9, {{2, 3, 4}}),
+      Perm(9, {{4, 5, 6, 7, 8}})
+    },
+    {
+      Perm(8, {{0, 1, 2, 3}, {4, 5, 6, 7}}),
+      Perm(8, {{0, 4}, {1, 5}}),
+      Perm(8, {{1, 3}, {5, 7}})
+    },
+    {
+      Perm(12, {{0, 1, 2}, {3, 4, 5}}),
+      Perm(12, {{0, 3}, {1, 4}, {2, 5}, {6, 9}}),
+      Perm(12, {{6, 7, 8}, {9, 10, 11}}),
+      Perm(12, {{0, 6}, {1, 7}, {2, 8}, {3, 9}, {4, 10}, {5, 11}})
+    }
+  };
+
+  for (auto const &gens : generators) {
+    BSGSOptions bsgs_options;
+    bsgs_options.construction = BSGSOptions::Construction::SCHREIER_SIMS;
+    bsgs_options.check_sym = false;
+    bsgs_options.schreier_sims_dedupe_schreier_generators = false;
+
+    auto expected_order(BSGS(gens, &bsgs_options).order());
+
+    bsgs_options.schreier_sims_dedupe_schreier_generators = true;
+
+    EXPECT_EQ(expected_order, BSGS(gens, &bsgs_options).order())
+      << "Deduplicating Schreier generators preserves group order.";
+
+    for (unsigned subset : {1u, 5u}) {
+      bsgs_options.schreier_sims_schreier_generator_subset = subset;
+
+      EXPECT_EQ(expected_order, BSGS(gens, &bsgs_options).order())
+        << "Random subsets of Schreier generators preserve group order "
+        << "(subset size is " << subset << ").";
+    }
+  }
+}
+
 TEST(PermGroupCombinationTest, CanConstructDirectProduct)
 {
   std::vector<std::vector<PermGroup>> direct_products {
@@ -440,6 +749,92 @@ TEST(PermGroupCombinationTest, CanConstructDirectProduct)
   }
 }
 
+TEST(PermGroupCombinationTest, CanConstructDirectProductFromFactorBSGSs)
+{
+  std::vector<PermGroup> factors {
+    PermGroup::symmetric(3),
+    PermGroup::cyclic(4),
+    PermGroup(2, {}),
+    PermGroup::dihedral(10),
+    PermGroup::alternating(4),
+    PermGroup({Perm(4, {{0, 1}, {2, 3}}), Perm(4, {{0, 2}})})
+  };
+
+  unsigned degree = 0u;
+  for (auto const &factor : factors)
+    degree += factor.degree();
+
+  PermSet generators;
+
+  unsigned offset = 0u;
+  for (auto const &factor : factors) {
+    for (Perm const &gen : factor.generators())
+      generators.insert(gen.shifted(offset).extended(degree));
+
+    offset += factor.degree();
+  }
+
+  PermGroup expected(degree, generators);
+
+  for (auto transversals : {BSGSOptions::Transversals::EXPLICIT,
+                            BSGSOptions::Transversals::SCHREIER_TREES}) {
+    BSGSOptions bsgs_options;
+    bsgs_options.transversals = transversals;
+
+    auto actual(PermGroup::direct_product(factors.begin(),
+                                          factors.end(),
+                                          &bsgs_options));
+
+    EXPECT_EQ(expected.order(), actual.order())
+      << "Direct product order correct.";
+
+    EXPECT_TRUE(expected == actual)
+      << "Direct product construction correct.";
+
+    for (unsigned i = 0u; i < 100u; ++i) {
+      EXPECT_TRUE(actual.contains_element(expected.random_element()))
+        << "Direct product contains random element.";
+    }
+  }
+}
+
+TEST(PermGroupCombinationTest, CanChangeBaseOfDirectProduct)
+{
+  // the strong generating sets of these factors are not closed under inversion
+  std::vector<PermGroup> factors {
+    PermGroup(5, {Perm(5, {{0, 1, 2, 3, 4}})}),
+    PermGroup(4, {Perm(4, {{0, 1, 2, 3}})})
+  };
+
+  auto direct_product(PermGroup::direct_product(factors.begin(), factors.end()));
+
+  PermGroup expected(direct_product.degree(), direct_product.generators());
+
+  for (unsigned i = 0u; i < direct_product.degree(); ++i) {
+    for (unsigned j = 0u; j < direct_product.degree(); ++j) {
+      if (j == i)
+        continue;
+
+      std::vector<unsigned> prefix {i, j};
+
+      auto bsgs(direct_product.bsgs(prefix));
+
+      EXPECT_TRUE(bsgs->has_base_prefix(prefix))
+        << "Base prefix of direct product changed correctly.";
+
+      EXPECT_EQ(expected.order(), bsgs->order())
+        << "Direct product order unchanged by base change.";
+
+      for (Perm const &perm : expected) {
+        if (!bsgs->strips_completely(perm)) {
+          ADD_FAILURE() << "Direct product elements still contained after base change.";
+          break;
+        }
+      }
+    }
+  }
+}
+
 TEST(PermGroupCombinationTest, CanConstructWreathProduct)
 {
   std::vector<std::pair<PermGroup, PermGroup>> wreath_products {
@@ -550,6 +945,46 @@ TEST(PermGroupCombinationTest, CanConstructWreathProduct)
   }
 }
 
+TEST(PermGroupCombinationTest, CanConstructWreathProductFromFactorBSGSs)
+{
+  std::vector<std::pair<PermGroup, PermGroup>> wreath_products {
+    {PermGroup::symmetric(3), PermGroup::cyclic(4)},
+    {PermGroup::cyclic(3), PermGroup::symmetric(4)},
+    {PermGroup::dihedral(8), PermGroup::dihedral(6)},
+    {PermGroup::alternating(4), PermGroup({Perm(5, {{0, 2}, {3, 4}})})},
+    {PermGroup({Perm(5, {{1, 3}}), Perm(5, {{2, 4}})}), PermGroup::cyclic(2)},
+    {PermGroup(3, {}), PermGroup::symmetric(3)},
+    {PermGroup::symmetric(3), PermGroup(3, {})}
+  };
+
+  for (auto transversals : {BSGSOptions::Transversals::EXPLICIT,
+                            BSGSOptions::Transversals::SCHREIER_TREES}) {
+    BSGSOptions bsgs_options;
+    bsgs_options.transversals = transversals;
+
+    for (auto const &wp : wreath_products) {
+      auto const &lhs(wp.first);
+      auto const &rhs(wp.second);
+
+      PermGroup expected(lhs.degree() * rhs.degree(),
+                         PermGroup::wreath_product_generators(lhs, rhs));
+
+      auto actual(PermGroup::wreath_product(lhs, rhs, &bsgs_options));
+
+      EXPECT_EQ(PermGroup::wreath_product_order(lhs, rhs), actual.order())
+        << "Wreath product order correct.";
+
+      EXPECT_TRUE(expected == actual)
+        << "Wreath product construction correct.";
+
+      for (unsigned i = 0u; i < 100u; ++i) {
+        EXPECT_TRUE(actual.contains_element(expected.random_element()))
+          << "Wreath product contains random element.";
+      }
+    }
+  }
+}
+
 class DisjointSubgroupProductTest :
   public testing::TestWithParam<std::pair<bool, bool>> {};
 
@@ -644,6 +1079,100 @@ INSTANTIATE_TEST_SUITE_P(DisjointSubgroupProductVariants,
                                                std::make_pair(true, false),
                                                std::make_pair(true, true)));
 
+TEST(DisjointSubgroupProductParallelTest, CanDecomposeInParallel)
+{
+  PermGroup pg(
+    {
+      Perm(15, {{0, 1, 2}}),
+      Perm(15, {{0, 1}}),
+      Perm(15, {{3, 4, 5}}),
+      Perm(15, {{6, 7}, {9, 10}}),
+      Perm(15, {{7, 8}, {10, 11}}),
+      Perm(15, {{12, 13}}),
+      Perm(15, {{13, 14}})
+    }
+  );
+
+  auto expected_disjoint_subgroups(pg.disjoint_decomposition());
+
+  ASSERT_EQ(4u, expected_disjoint_subgroups.size())
+    << "Disjoint subgroup product decomposition generated correctly.";
+
+  for (unsigned num_threads : {2u, 3u, 4u}) {
+    EXPECT_EQ(expected_disjoint_subgroups,
+              pg.disjoint_decomposition(true, false, num_threads))
+      << "Parallel disjoint subgroup product decomposition generated correctly ("
+      << num_threads << " threads).";
+  }
+}
+
+TEST(WreathProductTest, CanDecomposeWreathProduct)
+{
+  PermGroup pg(8,
+    {
+      Perm(8, {{0, 1}}),
+      Perm(8, {{0, 2, 4, 6}, {1, 3, 5, 7}})
+    }
+  );
+
+  auto decomp(pg.wreath_decomposition());
+
+  ASSERT_EQ(5u, decomp.size())
+    << "Wreath product decomposition found.";
+
+  EXPECT_EQ(PermGroup(8, {Perm(8, {{0, 2, 4, 6}, {1, 3, 5, 7}})}), decomp[0])
+    << "Block permuter monomorphism image generated correctly.";
+
+  std::vector<PermGroup> expected_stabilizers {
+    PermGroup(8, {Perm(8, {{0, 1}})}),
+    PermGroup(8, {Perm(8, {{2, 3}})}),
+    PermGroup(8, {Perm(8, {{4, 5}})}),
+    PermGroup(8, {Perm(8, {{6, 7}})})
+  };
+
+  std::vector<PermGroup> stabilizers(decomp.begin() + 1, decomp.end());
+  EXPECT_THAT(stabilizers, UnorderedElementsAreArray(expected_stabilizers))
+    << "Block stabilizers generated correctly.";
+}
+
+TEST(WreathProductTest, DoesNotDecomposeIncorrectly)
+{
+  PermGroup pg(9,
+    {
+      Perm(9, {{0, 4, 7}}),
+      Perm(9, {{1, 2, 5}}),
+      Perm(9, {{1, 6}, {2, 3}, {5, 8}}),
+      Perm(9, {{3, 8, 6}}),
+      Perm(9, {{0, 3}, {4, 8}, {6, 7}})
+    }
+  );
+
+  auto decomp(pg.wreath_decomposition());
+
+  if (!decomp.empty()) {
+    BSGS::order_type decomp_order = 1;
+
+    for (PermGroup const &factor : decomp) {
+      for (Perm const &gen : factor.generators()) {
+        EXPECT_TRUE(pg.contains_element(gen))
+          << "Wreath product decomposition factors contained in group.";
+      }
+
+      decomp_order *= factor.order();
+    }
+
+    EXPECT_EQ(pg.order(), decomp_order)
+      << "Wreath product decomposition factor orders correct.";
+  }
+
+  PermGroup pg_intransitive(
+    PermGroup::wreath_product(PermGroup::dihedral(4),
+                              PermGroup::cyclic(3)).generators());
+
+  EXPECT_TRUE(pg_intransitive.wreath_decomposition().empty())
+    << "Intransitive group not wreath product decomposed.";
+}
+
 //TEST(DISABLED_WreathProductTest, CanFindWreathProduct)
 //{
 //  PermGroup pg(12,
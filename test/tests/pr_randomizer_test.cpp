@@ -7,6 +7,7 @@
 #include "perm.hpp"
 #include "perm_set.hpp"
 #include "pr_randomizer.hpp"
+#include "random.hpp"
 
 #include "test_main.cpp"
 
@@ -79,6 +80,22 @@ TEST_F(PRRandomizerTest, DistributionApproximatelyUniform)
   }
 }
 
+TEST_F(PRRandomizerTest, ReproducibleWithSeededEngine)
+{
+  PermSet generators {Perm(6, {{0, 1}}), Perm(6, {{0, 1, 2, 3, 4, 5}})};
+
+  auto re1(util::random_engine(42u));
+  auto re2(util::random_engine(42u));
+
+  PrRandomizer pr1(generators, &re1);
+  PrRandomizer pr2(generators, &re2);
+
+  for (int j = 0; j < 100; ++j) {
+    EXPECT_EQ(pr1.next(), pr2.next())
+      << "Equally seeded product replacement randomizers agree.";
+  }
+}
+
 TEST_F(PRRandomizerTest, CanTestForAltSym)
 {
   auto symmetric_generators = [](unsigned n) {
@@ -63,6 +63,10 @@ TYPED_TEST(SchreierStructureTest, CanConstructSchreierStructures)
       << "Node (orbit) correct "
       << "(root is " << root << ").";
 
+    EXPECT_EQ(orbit.size(), schreier_structure->size())
+      << "Size (orbit length) correct "
+      << "(root is " << root << ").";
+
     for (unsigned x = 1u; x < n; ++x) {
       auto it(std::find(orbit.begin(), orbit.end(), x));
       bool contained = it != orbit.end();
@@ -92,3 +96,38 @@ TYPED_TEST(SchreierStructureTest, CanConstructSchreierStructures)
     }
   }
 }
+
+TYPED_TEST(SchreierStructureTest, CanIdentifyIncomingEdges)
+{
+  unsigned n = 6;
+
+  PermSet generators {
+    Perm(n, {{0, 1, 2, 3}}),
+    Perm(n, {{0, 2}, {4, 5}})
+  };
+
+  generators.insert_inverses();
+
+  auto schreier_structure(std::make_shared<TypeParam>(n, 0u, generators));
+
+  auto orbit(Orbit::generate(0u, generators, schreier_structure));
+
+  unsigned num_incoming = 0u;
+
+  for (unsigned x : orbit) {
+    for (Perm const &gen : generators) {
+      if (!schreier_structure->incoming(x, gen))
+        continue;
+
+      ++num_incoming;
+
+      EXPECT_EQ(schreier_structure->transversal(x) * gen,
+                schreier_structure->transversal(gen[x]))
+        << "Incoming edge " << gen << " at " << x << " yields trivial "
+        << "Schreier generator.";
+    }
+  }
+
+  EXPECT_EQ(orbit.size() - 1u, num_incoming)
+    << "Every non-root orbit element has exactly one incoming edge.";
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "perm.hpp"
+#include "task_mapping.hpp"
+#include "task_mapping_compact.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym;
+using namespace mpsym::internal;
+
+namespace
+{
+
+std::vector<TaskMapping> random_mappings(unsigned num_mappings,
+                                         unsigned mapping_size,
+                                         unsigned task_max)
+{
+  std::mt19937 re(42u);
+  std::uniform_int_distribution<unsigned> d(0u, task_max);
+
+  std::vector<TaskMapping> mappings;
+
+  for (unsigned i = 0u; i < num_mappings; ++i) {
+    std::vector<unsigned> tasks(mapping_size);
+    for (auto &task : tasks)
+      task = d(re);
+
+    mappings.emplace_back(tasks);
+  }
+
+  return mappings;
+}
+
+Perm random_perm(unsigned degree)
+{
+  std::mt19937 re(42u);
+
+  std::vector<unsigned> perm(degree);
+  for (unsigned i = 0u; i < degree; ++i)
+    perm[i] = i;
+
+  std::shuffle(perm.begin(), perm.end(), re);
+
+  return Perm(perm);
+}
+
+} // anonymous namespace
+
+template<typename T>
+class CompactTaskMappingTest : public testing::Test {};
+
+using CompactTaskMappingTypes = testing::Types<CompactTaskMapping8,
+                                               CompactTaskMapping16,
+                                               CompactTaskMapping<uint8_t, 80u>>;
+
+TYPED_TEST_SUITE(CompactTaskMappingTest, CompactTaskMappingTypes,);
+
+TYPED_TEST(CompactTaskMappingTest, CanConvertMapping)
+{
+  for (auto const &mapping : random_mappings(100u, TypeParam::capacity, 15u)) {
+    TypeParam mapping_compact(mapping);
+
+    EXPECT_EQ(mapping, mapping_compact.to_task_mapping())
+      << "Converting mapping to and from compact mapping correct.";
+  }
+
+  TaskMapping mapping_too_long(std::vector<unsigned>(TypeParam::capacity + 1u));
+
+  EXPECT_THROW(TypeParam mapping_compact(mapping_too_long), std::invalid_argument)
+    << "Converting too long mapping throws.";
+
+  TaskMapping mapping_too_wide({0u, TypeParam::task_max + 1u});
+
+  EXPECT_THROW(TypeParam mapping_compact(mapping_too_wide), std::invalid_argument)
+    << "Converting mapping with too large task throws.";
+}
+
+TYPED_TEST(CompactTaskMappingTest, CanCompareMappings)
+{
+  for (unsigned mapping_size : {1u, 7u, TypeParam::capacity}) {
+    auto mappings(random_mappings(100u, mapping_size, 3u));
+
+    for (auto const &lhs : mappings) {
+      for (auto const &rhs : mappings) {
+        TypeParam lhs_compact(lhs), rhs_compact(rhs);
+
+        EXPECT_EQ(lhs.less_than(rhs), lhs_compact.less_than(rhs_compact))
+          << "Comparing compact mappings correct.";
+
+        EXPECT_EQ(lhs == rhs, lhs_compact == rhs_compact)
+          << "Checking compact mappings for equality correct.";
+      }
+    }
+  }
+}
+
+TYPED_TEST(CompactTaskMappingTest, CanPermuteMapping)
+{
+  for (unsigned degree : {4u, 12u, 40u}) {
+    for (unsigned offset : {0u, 3u}) {
+      auto perm(random_perm(degree));
+
+      for (auto const &mapping :
+           random_mappings(100u, TypeParam::capacity - 3u, degree + 2u * offset)) {
+
+        TypeParam mapping_compact(mapping);
+
+        auto mapping_permuted(mapping.permuted(perm, offset));
+        auto mapping_compact_permuted(mapping_compact.permuted(perm, offset));
+
+        EXPECT_EQ(mapping_permuted, mapping_compact_permuted.to_task_mapping())
+          << "Permuting compact mapping correct.";
+
+        EXPECT_EQ(TypeParam(mapping_permuted), mapping_compact_permuted)
+          << "Permuted compact mapping equal to converted permuted mapping.";
+      }
+    }
+  }
+}
+
+TYPED_TEST(CompactTaskMappingTest, CanHashMappings)
+{
+  auto mappings(random_mappings(100u, 5u, 3u));
+
+  std::unordered_set<TaskMapping> mappings_set;
+  std::unordered_set<TypeParam> mappings_compact_set;
+
+  for (auto const &mapping : mappings) {
+    mappings_set.insert(mapping);
+    mappings_compact_set.insert(TypeParam(mapping));
+  }
+
+  EXPECT_EQ(mappings_set.size(), mappings_compact_set.size())
+    << "Hashing compact mappings correct.";
+}
@@ -0,0 +1,416 @@
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gmock/gmock.h"
+
+#include "task_mapping.hpp"
+#include "task_mapping_orbit.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym;
+
+using testing::UnorderedElementsAreArray;
+
+namespace
+{
+
+std::vector<TaskMapping> mappings_with_duplicates()
+{
+  std::vector<TaskMapping> mappings;
+  for (unsigned i = 0u; i < 1000u; ++i)
+    mappings.emplace_back(TaskMapping({(i * 7u) % 100u, (i * 13u) % 50u}));
+
+  return mappings;
+}
+
+} // anonymous namespace
+
+TEST(TMORsTest, CanInsertRepresentatives)
+{
+  TMORs orbits;
+
+  EXPECT_EQ(std::make_pair(true, 0u), orbits.insert(TaskMapping({0u, 1u, 0u})))
+    << "First representative inserted correctly.";
+
+  EXPECT_EQ(std::make_pair(true, 1u), orbits.insert(TaskMapping({1u, 0u, 1u})))
+    << "Second representative inserted correctly.";
+
+  EXPECT_EQ(std::make_pair(false, 0u), orbits.insert(TaskMapping({0u, 1u, 0u})))
+    << "Duplicate representative not inserted.";
+
+  EXPECT_EQ(2u, orbits.num_orbits())
+    << "Number of orbits correct.";
+
+  EXPECT_TRUE(orbits.is_repr(TaskMapping({1u, 0u, 1u})))
+    << "Inserted mapping is representative.";
+
+  EXPECT_FALSE(orbits.is_repr(TaskMapping({1u, 1u, 1u})))
+    << "Mapping never inserted is not a representative.";
+
+  EXPECT_FALSE(orbits.is_repr(TaskMapping({1u, 0u, 2u})))
+    << "Mapping exceeding task width is not a representative.";
+
+  EXPECT_FALSE(orbits.is_repr(TaskMapping({1u, 0u})))
+    << "Mapping of different length is not a representative.";
+
+  EXPECT_THROW(orbits.insert(TaskMapping({1u, 0u})), std::invalid_argument)
+    << "Inserting mapping of different length throws.";
+}
+
+TEST(TMORsTest, CanWidenTasks)
+{
+  TMORs orbits;
+
+  std::vector<TaskMapping> mappings {
+    TaskMapping({0u, 1u, 1u, 0u}),
+    TaskMapping({3u, 2u, 1u, 0u}),
+    TaskMapping({255u, 0u, 17u, 3u}),
+    TaskMapping({0u, 1u, 1u, 0u}),
+    TaskMapping({70000u, 1u, 255u, 0u}),
+    TaskMapping({UINT_MAX, 0u, UINT_MAX - 1u, 1u})
+  };
+
+  for (auto const &mapping : mappings)
+    orbits.insert(mapping);
+
+  EXPECT_EQ(5u, orbits.num_orbits())
+    << "Number of orbits correct.";
+
+  std::vector<TaskMapping> reprs;
+  for (auto const &repr : orbits)
+    reprs.push_back(repr);
+
+  std::vector<TaskMapping> reprs_expected {
+    mappings[0], mappings[1], mappings[2], mappings[4], mappings[5]
+  };
+
+  EXPECT_EQ(reprs_expected, reprs)
+    << "Iteration yields representatives in insertion order.";
+
+  for (auto const &mapping : mappings) {
+    EXPECT_TRUE(orbits.is_repr(mapping))
+      << "Representative still found after widening tasks.";
+  }
+}
+
+TEST(TMORsTest, CanCompareRepresentatives)
+{
+  auto mappings(mappings_with_duplicates());
+
+  TMORs orbits, orbits_reversed, orbits_partial;
+
+  orbits.insert_all(mappings.begin(), mappings.end());
+  orbits_reversed.insert_all(mappings.rbegin(), mappings.rend());
+  orbits_partial.insert_all(mappings.begin(), mappings.begin() + 50);
+
+  EXPECT_EQ(orbits, orbits_reversed)
+    << "Representatives inserted in different order compare equal.";
+
+  EXPECT_NE(orbits, orbits_partial)
+    << "Representatives subset compares unequal.";
+
+  EXPECT_EQ(TMORs(), TMORs())
+    << "Empty representatives compare equal.";
+
+  std::set<TaskMapping> reprs_expected(mappings.begin(), mappings.end());
+
+  std::set<TaskMapping> reprs;
+  for (auto const &repr : orbits)
+    reprs.insert(repr);
+
+  EXPECT_EQ(reprs_expected, reprs)
+    << "Iteration yields all representatives.";
+}
+
+TEST(TMORsTest, CanRecordFilterStats)
+{
+  auto mappings(mappings_with_duplicates());
+
+  TMORs orbits;
+  orbits.insert_all(mappings.begin(), mappings.end());
+
+  for (unsigned i = 0u; i < 100u; ++i)
+    orbits.is_repr(mappings[i]);
+
+  unsigned num_misses = 0u;
+  for (unsigned i = 0u; i < 100u; ++i) {
+    for (unsigned j = 0u; j < 100u; ++j) {
+      if (!orbits.is_repr(TaskMapping({i + 100u, j})))
+        ++num_misses;
+    }
+  }
+
+  EXPECT_EQ(10000u, num_misses)
+    << "Mappings never inserted are not representatives.";
+
+  auto stats(orbits.filter_stats());
+
+  EXPECT_EQ(100u, stats.hits)
+    << "Filter hits recorded correctly.";
+
+  EXPECT_EQ(10000u, stats.misses + stats.false_positives)
+    << "Filter misses recorded correctly.";
+
+  EXPECT_LT(stats.false_positives, 100u)
+    << "Filter false positive rate low.";
+
+  orbits.reset_filter_stats();
+
+  stats = orbits.filter_stats();
+
+  EXPECT_EQ(0u, stats.hits + stats.misses + stats.false_positives)
+    << "Filter stats reset correctly.";
+}
+
+class TMORsFileTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    file = testing::TempDir() + "mpsym_tmors_" + std::to_string(::getpid());
+    std::remove(file.c_str());
+  }
+
+  void TearDown() override
+  { std::remove(file.c_str()); }
+
+  std::string file;
+};
+
+TEST_F(TMORsFileTest, CanStoreRepresentativesInFile)
+{
+  auto mappings(mappings_with_duplicates());
+
+  TMORs orbits_expected;
+  orbits_expected.insert_all(mappings.begin(), mappings.end());
+
+  {
+    TMORs orbits(file);
+
+    EXPECT_TRUE(orbits.file_backed())
+      << "Representatives file backed.";
+
+    orbits.insert_all(mappings.begin(), mappings.end());
+
+    EXPECT_EQ(orbits_expected, orbits)
+      << "File backed representatives correct.";
+
+    TMORs orbits_copy(orbits);
+
+    EXPECT_FALSE(orbits_copy.file_backed())
+      << "Copy of file backed representatives held in memory.";
+
+    EXPECT_EQ(orbits_expected, orbits_copy)
+      << "Copy of file backed representatives correct.";
+  }
+
+  TMORs orbits(file);
+
+  EXPECT_EQ(orbits_expected, orbits)
+    << "Representatives correctly loaded from file.";
+
+  for (auto const &mapping : mappings) {
+    EXPECT_EQ(orbits_expected.insert(mapping), orbits.insert(mapping))
+      << "Equivalence class IDs preserved after loading from file.";
+  }
+
+  auto mapping_new(TaskMapping({1000u, 1000u}));
+
+  EXPECT_EQ(std::make_pair(true, orbits_expected.num_orbits()),
+            orbits.insert(mapping_new))
+    << "New representative appended after loading from file.";
+
+  EXPECT_TRUE(orbits.is_repr(mappings.back()))
+    << "Representative found after widening tasks.";
+
+  EXPECT_FALSE(std::ifstream(file + ".tmp").good())
+    << "No temporary file left behind after widening tasks.";
+
+  EXPECT_EQ(orbits, TMORs(file))
+    << "Representatives with widened tasks correctly loaded from file.";
+}
+
+TEST_F(TMORsFileTest, CanResumeAfterCrash)
+{
+  auto mappings(mappings_with_duplicates());
+
+  TMORs orbits_expected;
+  orbits_expected.insert_all(mappings.begin(), mappings.end());
+
+  pid_t pid = ::fork();
+  ASSERT_NE(-1, pid);
+
+  if (pid == 0) {
+    TMORs orbits(file);
+    orbits.insert_all(mappings.begin(), mappings.end());
+
+    // terminate without running any destructors
+    ::_exit(0);
+  }
+
+  int status;
+  ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+
+  TMORs orbits(file);
+
+  EXPECT_EQ(orbits_expected, orbits)
+    << "Representatives correctly recovered after crash.";
+}
+
+TEST_F(TMORsFileTest, CanResumeAfterInterruptedCommit)
+{
+  std::vector<TaskMapping> mappings {
+    TaskMapping({0u, 1u, 2u}),
+    TaskMapping({2u, 1u, 0u}),
+    TaskMapping({1u, 1u, 1u})
+  };
+
+  {
+    TMORs orbits(file);
+    orbits.insert_all(mappings.begin(), mappings.end());
+  }
+
+  // simulate an interruption of the last commit after the number of words but
+  // before the number of orbits (the fifth header field) was updated
+  {
+    std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+
+    uint64_t num_orbits = mappings.size() - 1u;
+
+    stream.seekp(4u * sizeof(uint64_t));
+    stream.write(reinterpret_cast<char const *>(&num_orbits), sizeof(uint64_t));
+  }
+
+  TMORs orbits(file);
+
+  EXPECT_EQ(mappings.size() - 1u, orbits.num_orbits())
+    << "Interrupted representative discarded.";
+
+  EXPECT_EQ(std::make_pair(true, 2u), orbits.insert(mappings.back()))
+    << "Interrupted representative inserted again.";
+
+  for (unsigned i = 0u; i < mappings.size(); ++i) {
+    EXPECT_EQ(mappings[i], orbits.repr(i))
+      << "Representatives correct after resuming interrupted commit.";
+  }
+}
+
+TEST_F(TMORsFileTest, RejectsInvalidFiles)
+{
+  std::ofstream stream(file);
+  stream << "not a representatives file, not a representatives file";
+  stream.close();
+
+  EXPECT_THROW(TMORs orbits(file), std::runtime_error)
+    << "Opening invalid representatives file throws.";
+}
+
+TEST(ConcurrentTMORsTest, CanInsertConcurrently)
+{
+  auto mappings(mappings_with_duplicates());
+
+  TMORs orbits_serial;
+  orbits_serial.insert_all(mappings.begin(), mappings.end());
+
+  for (unsigned num_shards : {1u, 5u, 64u}) {
+    ConcurrentTMORs orbits(num_shards);
+
+    std::vector<std::vector<std::pair<bool, unsigned>>> res(4);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0u; t < res.size(); ++t) {
+      threads.emplace_back([&, t]{
+        for (auto const &mapping : mappings)
+          res[t].push_back(orbits.insert(mapping));
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+
+    EXPECT_EQ(orbits_serial.num_orbits(), orbits.num_orbits())
+      << "Number of orbits correct (" << num_shards << " shards).";
+
+    std::vector<TaskMapping> reprs, reprs_serial;
+
+    for (auto const &repr : orbits)
+      reprs.push_back(repr);
+
+    for (auto const &repr : orbits_serial)
+      reprs_serial.push_back(repr);
+
+    EXPECT_THAT(reprs, UnorderedElementsAreArray(reprs_serial))
+      << "Iteration yields all representatives (" << num_shards << " shards).";
+
+    unsigned num_new = 0u;
+    std::unordered_set<unsigned> equivalence_classes;
+
+    for (unsigned i = 0u; i < mappings.size(); ++i) {
+      for (auto const &res_thread : res) {
+        if (res_thread[i].first)
+          ++num_new;
+
+        EXPECT_EQ(res[0][i].second, res_thread[i].second)
+          << "Equivalence class IDs consistent between threads.";
+
+        equivalence_classes.insert(res_thread[i].second);
+      }
+
+      EXPECT_TRUE(orbits.is_repr(mappings[i]))
+        << "Inserted mapping is representative.";
+    }
+
+    EXPECT_EQ(orbits.num_orbits(), num_new)
+      << "Every representative reported as new exactly once.";
+
+    EXPECT_EQ(orbits.num_orbits(), equivalence_classes.size())
+      << "Equivalence class IDs are unique.";
+
+    EXPECT_FALSE(orbits.is_repr(TaskMapping({100u, 100u})))
+      << "Mapping never inserted is not a representative.";
+  }
+}
+
+TEST(ConcurrentTMORsTest, CanInsertDeterministically)
+{
+  auto mappings(mappings_with_duplicates());
+
+  TMORs orbits_serial;
+
+  std::vector<std::pair<bool, unsigned>> res_serial;
+  for (auto const &mapping : mappings)
+    res_serial.push_back(orbits_serial.insert(mapping));
+
+  ConcurrentTMORs orbits;
+
+  unsigned num_threads = 4u;
+
+  std::vector<std::pair<bool, unsigned>> res(mappings.size());
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0u; t < num_threads; ++t) {
+    threads.emplace_back([&, t]{
+      for (unsigned i = t; i < mappings.size(); i += num_threads)
+        res[i] = orbits.insert(mappings[i], i);
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(res_serial, res)
+    << "Equivalence class IDs equal to those assigned in serial order.";
+}
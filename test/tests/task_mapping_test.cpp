@@ -0,0 +1,94 @@
+#include "gmock/gmock.h"
+
+#include "perm.hpp"
+#include "perm_set.hpp"
+#include "task_mapping.hpp"
+
+#include "test_main.cpp"
+
+using namespace mpsym;
+using namespace mpsym::internal;
+
+TEST(TaskMappingTest, CanPermuteMapping)
+{
+  TaskMapping mapping({1u, 5u, 2u, 0u, 7u});
+
+  Perm perm({1, 2, 0, 3});
+
+  bool modified;
+  EXPECT_EQ(TaskMapping({2u, 5u, 3u, 0u, 7u}),
+            mapping.permuted(perm, 1u, &modified))
+    << "Permuting mapping correct (ignoring tasks outside of range).";
+
+  EXPECT_TRUE(modified)
+    << "Permuted mapping marked as modified.";
+
+  mapping.permuted(Perm(4), 1u, &modified);
+
+  EXPECT_FALSE(modified)
+    << "Mapping permuted by identity not marked as modified.";
+
+  PermSet perm_word({perm, Perm({0, 1, 3, 2})});
+
+  EXPECT_EQ(TaskMapping({2u, 3u, 4u, 1u}),
+            TaskMapping({1u, 2u, 3u, 4u}).permuted(perm_word, 1u))
+    << "Permuting mapping by permutation word correct.";
+}
+
+TEST(TaskMappingTest, CanPermuteMappingIntoBuffer)
+{
+  TaskMapping mapping({1u, 5u, 2u, 0u, 7u});
+
+  Perm perm({1, 2, 0, 3});
+
+  TaskMapping buffer;
+  buffer.reserve(mapping.size());
+
+  auto buffer_data = buffer.data();
+
+  mapping.permuted_into(buffer, perm, 1u);
+
+  EXPECT_EQ(mapping.permuted(perm, 1u), buffer)
+    << "Permuting mapping into buffer correct.";
+
+  mapping.permuted_into(buffer, Perm(4), 1u);
+
+  EXPECT_EQ(mapping, buffer)
+    << "Permuting mapping into non-empty buffer correct.";
+
+  EXPECT_EQ(buffer_data, buffer.data())
+    << "Buffer reused.";
+}
+
+TEST(TaskMappingTest, CanComparePermutedMapping)
+{
+  TaskMapping mapping({1u, 2u, 2u});
+  TaskMapping other({1u, 2u, 0u});
+
+  Perm perm({1, 0, 2});
+
+  unsigned position;
+  EXPECT_EQ(-1, mapping.compare(other, perm, 0u, &position))
+    << "Comparing permuted mapping correct.";
+
+  EXPECT_EQ(0u, position)
+    << "First differing position correct.";
+
+  EXPECT_EQ(1, mapping.compare(other, Perm(3), 0u, &position))
+    << "Comparing mapping permuted by identity correct.";
+
+  EXPECT_EQ(2u, position)
+    << "First differing position correct.";
+
+  EXPECT_EQ(0, mapping.compare(mapping, Perm(3)))
+    << "Comparing mapping to itself correct.";
+
+  EXPECT_TRUE(mapping.less_than(other, perm))
+    << "Permuted mapping smaller.";
+
+  EXPECT_FALSE(mapping.less_than(other))
+    << "Mapping not smaller.";
+
+  EXPECT_TRUE(other.less_than(mapping))
+    << "Other mapping smaller.";
+}
@@ -1,5 +1,9 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 
@@ -49,3 +53,47 @@ INSTANTIATE_TEST_SUITE_P(FactorialTestInstances, FactorialTest,
                   std::make_pair(1u, 1u),
                   std::make_pair(5u, 120u),
                   std::make_pair(7u, 5040u)));
+
+TEST(OnceFlagTest, CanInitializeOnce)
+{
+  OnceFlag flag;
+
+  std::atomic<unsigned> calls(0u);
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0u; t < 4u; ++t)
+    threads.emplace_back([&]{ flag.call_once([&]{ ++calls; }); });
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_TRUE(flag.done())
+    << "Flag set after initialization.";
+
+  EXPECT_EQ(1u, calls)
+    << "Initialization performed exactly once.";
+
+  flag.reset();
+  flag.call_once([&]{ ++calls; });
+
+  EXPECT_EQ(2u, calls)
+    << "Initialization performed again after reset.";
+}
+
+TEST(OnceFlagTest, CanRetryFailedInitialization)
+{
+  OnceFlag flag;
+
+  EXPECT_THROW(flag.call_once([]{ throw std::runtime_error("failed"); }),
+               std::runtime_error)
+    << "Initialization exception propagated.";
+
+  EXPECT_FALSE(flag.done())
+    << "Flag not set after failed initialization.";
+
+  bool called = false;
+  flag.call_once([&]{ called = true; });
+
+  EXPECT_TRUE(called && flag.done())
+    << "Initialization retried after failure.";
+}